@@ -0,0 +1,66 @@
+#include "undoable/CommandQueue.h"
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+using namespace undoable;
+
+namespace {
+
+class Increment : public Command {
+public:
+	Increment(long& value) : value_(value) {}
+
+	virtual void Apply(bool reverse) override {
+		value_ += reverse ? -1 : 1;
+	}
+
+private:
+	long& value_;
+};
+
+void Run(int producers, int batches, int batch_size) {
+	History h;
+	CommandQueue q;
+	long value = 0;
+	std::vector<std::thread> threads;
+
+	auto start = std::chrono::steady_clock::now();
+	for (int i = 0; i < producers; ++i) {
+		threads.emplace_back([&]() {
+			for (int k = 0; k < batches; ++k) {
+				CommandQueue::Batch batch;
+				for (int j = 0; j < batch_size; ++j) {
+					batch.Add(MakeUnique<Increment>(value));
+				}
+				q.Submit(std::move(batch));
+			}
+		});
+	}
+
+	std::size_t total = static_cast<std::size_t>(producers) * batches;
+	std::size_t drained = 0;
+	while (drained < total) {
+		drained += q.Drain(h);
+		h.Clear();
+	}
+	for (auto& thread : threads) {
+		thread.join();
+	}
+	auto end = std::chrono::steady_clock::now();
+
+	auto seconds = std::chrono::duration<double>(end - start).count();
+	std::cout << producers << " producers, "
+		<< total << " batches of " << batch_size << ": "
+		<< static_cast<long>(total / seconds) << " batches/s" << std::endl;
+}
+
+} // namespace
+
+int main() {
+	for (int producers : {1, 2, 4, 8}) {
+		Run(producers, 100000 / producers, 4);
+	}
+	return 0;
+}
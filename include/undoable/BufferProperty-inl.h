@@ -0,0 +1,146 @@
+#pragma once
+#include <algorithm>
+#include <cassert>
+
+
+namespace undoable {
+
+template<typename Buffer>
+BufferProperty<Buffer>::BufferProperty(PropertyOwner* owner, Buffer value)
+	: Property(owner)
+	, value_(std::move(value))
+{}
+
+template<typename Buffer>
+void BufferProperty<Buffer>::Spill(SpillWriter& writer) {
+	writer.Write(value_);
+}
+
+template<typename Buffer>
+void BufferProperty<Buffer>::Reload(SpillReader& reader) {
+	reader.Read(value_);
+}
+
+template<typename Buffer>
+std::uint64_t BufferProperty<Buffer>::Hash() const {
+	return TryHashValue(value_);
+}
+
+template<typename Buffer>
+const Buffer& BufferProperty<Buffer>::Get() const {
+	return value_;
+}
+
+template<typename Buffer>
+std::size_t BufferProperty<Buffer>::Size() const {
+	return value_.size();
+}
+
+template<typename Buffer>
+bool BufferProperty<Buffer>::IsEmpty() const {
+	return value_.empty();
+}
+
+template<typename Buffer>
+void BufferProperty<Buffer>::Set(const Buffer& value) {
+	auto size = std::min(value.size(), value_.size());
+	auto prefix = static_cast<std::size_t>(std::mismatch(
+		value.begin(), value.begin() + size, value_.begin()).first
+		- value.begin());
+
+	size -= prefix;
+	auto suffix = static_cast<std::size_t>(std::mismatch(
+		value.rbegin(), value.rbegin() + size, value_.rbegin()).first
+		- value.rbegin());
+
+	auto count = value_.size() - prefix - suffix;
+	Replace(prefix, count,
+		Buffer(value.begin() + prefix, value.end() - suffix));
+}
+
+template<typename Buffer>
+void BufferProperty<Buffer>::Replace(
+	std::size_t offset, std::size_t count, Buffer value)
+{
+	assert(offset + count <= value_.size() && "Range out of bounds");
+	if (count == value.size() && std::equal(
+		value.begin(), value.end(), value_.begin() + offset))
+	{
+		return;
+	}
+
+	auto cmd = MakeUnique<Edit>(this, offset, count, std::move(value));
+	owner_->ApplyPropertyChange(std::move(cmd));
+}
+
+template<typename Buffer>
+void BufferProperty<Buffer>::Insert(std::size_t offset, Buffer value) {
+	Replace(offset, 0, std::move(value));
+}
+
+template<typename Buffer>
+void BufferProperty<Buffer>::Erase(std::size_t offset, std::size_t count) {
+	Replace(offset, count, Buffer());
+}
+
+template<typename Buffer>
+void BufferProperty<Buffer>::Append(Buffer value) {
+	Replace(value_.size(), 0, std::move(value));
+}
+
+
+// BufferProperty<Buffer>::Edit
+
+template<typename Buffer>
+BufferProperty<Buffer>::Edit::Edit(BufferProperty* property,
+		std::size_t offset, std::size_t count, Buffer value)
+	: property_(property)
+	, offset_(offset)
+	, count_(count)
+	, value_(std::move(value))
+{}
+
+template<typename Buffer>
+void BufferProperty<Buffer>::Edit::Apply(bool reverse) {
+	ApplyPartitioned(reverse);
+	Notify();
+}
+
+template<typename Buffer>
+const void* BufferProperty<Buffer>::Edit::Partition() const {
+	return property_->owner_;
+}
+
+template<typename Buffer>
+void BufferProperty<Buffer>::Edit::ApplyPartitioned(bool reverse) {
+	auto& buffer = property_->value_;
+	auto first = buffer.begin() + offset_;
+
+	if (count_ == value_.size()) {
+		std::swap_ranges(value_.begin(), value_.end(), first);
+	} else {
+		auto last = first + count_;
+		Buffer removed(first, last);
+		first = buffer.erase(first, last);
+		buffer.insert(first, value_.begin(), value_.end());
+		count_ = value_.size();
+		value_ = std::move(removed);
+	}
+}
+
+template<typename Buffer>
+void BufferProperty<Buffer>::Edit::Notify() {
+	property_->NotifyOwner();
+}
+
+template<typename Buffer>
+void BufferProperty<Buffer>::Edit::Spill(SpillWriter& writer) {
+	writer.Write(value_);
+}
+
+template<typename Buffer>
+void BufferProperty<Buffer>::Edit::Reload(SpillReader& reader) {
+	reader.Read(value_);
+}
+
+} // namespace undoable
@@ -0,0 +1,70 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "undoable/Property.h"
+#include "undoable/Command.h"
+#include "undoable/Hash.h"
+#include "undoable/Spill.h"
+
+
+namespace undoable {
+
+/**
+ * Property for large strings and byte buffers. Changes are recorded as
+ * edit deltas (offset, removed range, inserted range), which are applied
+ * in place in both directions.
+ */
+template<typename Buffer>
+class BufferProperty
+	: public Property {
+public:
+	BufferProperty(PropertyOwner* owner, Buffer value=Buffer());
+	virtual void OnReset() override {}
+	virtual std::uint64_t Hash() const override;
+	virtual void Spill(SpillWriter& writer) override;
+	virtual void Reload(SpillReader& reader) override;
+
+	const Buffer& Get() const;
+	std::size_t Size() const;
+	bool IsEmpty() const;
+
+	/**
+	 * Only the range between the common prefix and suffix
+	 * of the old and new value is recorded.
+	 */
+	void Set(const Buffer& value);
+
+	void Replace(std::size_t offset, std::size_t count, Buffer value);
+	void Insert(std::size_t offset, Buffer value);
+	void Erase(std::size_t offset, std::size_t count);
+	void Append(Buffer value);
+
+private:
+	class Edit : public Command {
+	public:
+		Edit(BufferProperty* property, std::size_t offset,
+			std::size_t count, Buffer value);
+		virtual void Apply(bool reverse) override;
+		virtual const void* Partition() const override;
+		virtual void ApplyPartitioned(bool reverse) override;
+		virtual void Notify() override;
+		virtual void Spill(SpillWriter& writer) override;
+		virtual void Reload(SpillReader& reader) override;
+
+	private:
+		BufferProperty* property_;
+		std::size_t offset_;
+		std::size_t count_;
+		Buffer value_;
+	};
+
+	Buffer value_;
+};
+
+using TextProperty = BufferProperty<std::string>;
+using BlobProperty = BufferProperty<std::vector<std::uint8_t>>;
+
+} // namespace undoable
+
+#include "undoable/BufferProperty-inl.h"
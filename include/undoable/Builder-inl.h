@@ -0,0 +1,19 @@
+#pragma once
+#include <type_traits>
+
+namespace undoable {
+
+template<typename Type, typename... Args>
+Type& Builder::Create(Args&&... args) {
+	static_assert(
+		std::is_base_of<Object, Type>::value,
+		"Missing base class");
+
+	Type* obj = new Type(args...);
+	ObjectBase::Link(head_.prev_object_, obj);
+	ObjectBase::Link(obj, &head_);
+	objects_.push_back(obj);
+	return *obj;
+}
+
+} // namespace undoable
@@ -0,0 +1,38 @@
+#pragma once
+#include <vector>
+#include "undoable/Object.h"
+
+
+namespace undoable {
+
+/**
+ * Builds objects without a History, e.g. on a worker thread. Property
+ * changes are applied in place, like in constructors. The objects are
+ * attached to a Factory as a whole by Factory::Attach(), as a single
+ * undoable command.
+ *
+ * Note: objects of a Builder should only reference each other, and they
+ * cannot be destroyed before they are attached.
+ */
+class Builder {
+public:
+	Builder() = default;
+	~Builder();
+	Builder(const Builder&) = delete;
+	Builder& operator=(const Builder&) = delete;
+
+	template<typename Type, typename... Args> Type& Create(Args&&... args);
+
+	bool IsEmpty() const;
+	std::size_t Size() const;
+
+private:
+	friend class Factory;
+
+	ObjectBase head_;
+	std::vector<Object*> objects_;
+};
+
+} // namespace undoable
+
+#include "undoable/Builder-inl.h"
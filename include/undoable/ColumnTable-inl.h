@@ -0,0 +1,118 @@
+#pragma once
+#include <algorithm>
+#include <cassert>
+#include <iterator>
+
+
+namespace undoable {
+
+// Column
+
+template<typename T>
+std::size_t Column<T>::Size() const {
+	return values_.size();
+}
+
+template<typename T>
+void Column<T>::Resize(std::size_t rows) {
+	if (rows != values_.size()) {
+		auto cmd = MakeUnique<ResizeChange>(this, rows);
+		owner_->ApplyPropertyChange(std::move(cmd));
+	}
+}
+
+template<typename T>
+void Column<T>::Spill(SpillWriter& writer) {
+	writer.Write(values_);
+}
+
+template<typename T>
+void Column<T>::Reload(SpillReader& reader) {
+	reader.Read(values_);
+}
+
+template<typename T>
+std::uint64_t Column<T>::Hash() const {
+	return TryHashValue(values_);
+}
+
+template<typename T>
+const T& Column<T>::Get(std::size_t row) const {
+	assert(row < values_.size() && "Row out of range");
+	return values_[row];
+}
+
+template<typename T>
+const T& Column<T>::operator[](std::size_t row) const {
+	return Get(row);
+}
+
+template<typename T>
+void Column<T>::Set(std::size_t row, T value) {
+	assert(row < values_.size() && "Row out of range");
+	if (value != values_[row]) {
+		auto cmd = MakeUnique<Change>(this, row, std::move(value));
+		owner_->ApplyPropertyChange(std::move(cmd));
+	}
+}
+
+template<typename T>
+const T* Column<T>::Data() const {
+	return values_.data();
+}
+
+template<typename T>
+typename Column<T>::const_iterator Column<T>::begin() const {
+	return values_.begin();
+}
+
+template<typename T>
+typename Column<T>::const_iterator Column<T>::end() const {
+	return values_.end();
+}
+
+
+// Column<T>::Change
+
+template<typename T>
+Column<T>::Change::Change(Column* column, std::size_t row, T value)
+	: column_(column)
+	, row_(row)
+	, value_(std::move(value))
+{}
+
+template<typename T>
+void Column<T>::Change::Apply(bool reverse) {
+	std::swap(column_->values_[row_], value_);
+	column_->NotifyOwner();
+}
+
+
+// Column<T>::ResizeChange
+
+template<typename T>
+Column<T>::ResizeChange::ResizeChange(Column* column, std::size_t rows)
+	: column_(column)
+	, rows_(rows)
+{}
+
+template<typename T>
+void Column<T>::ResizeChange::Apply(bool reverse) {
+	auto& values = column_->values_;
+	auto rows = values.size();
+	auto first = values.begin() + std::min(rows, rows_);
+
+	std::vector<T> removed(
+		std::make_move_iterator(first), std::make_move_iterator(values.end()));
+	values.erase(first, values.end());
+	values.insert(values.end(),
+		std::make_move_iterator(tail_.begin()),
+		std::make_move_iterator(tail_.end()));
+	values.resize(rows_);
+
+	tail_ = std::move(removed);
+	rows_ = rows;
+	column_->NotifyOwner();
+}
+
+} // namespace undoable
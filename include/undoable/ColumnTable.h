@@ -0,0 +1,117 @@
+#pragma once
+#include <vector>
+#include "undoable/Object.h"
+#include "undoable/Property.h"
+#include "undoable/Command.h"
+#include "undoable/Hash.h"
+#include "undoable/Spill.h"
+
+
+namespace undoable {
+
+class ColumnBase;
+class ColumnTable;
+
+template<typename T> class Column;
+
+
+class ColumnBase
+	: public Property
+{
+public:
+	ColumnBase(ColumnTable* table);
+	virtual void OnReset() override {}
+
+	virtual std::size_t Size() const = 0;
+	virtual void Resize(std::size_t rows) = 0;
+};
+
+
+/**
+ * Object storing homogeneous rows column by column. Every `Column<T>`
+ * member holds its values in a contiguous array, so scanning one field
+ * across all rows is sequential.
+ *
+ * Note: rows are not objects. They have no lifecycle and no OnCreate(),
+ * OnDestroy() or OnPropertyChange() of their own, and they cannot be the
+ * target of a RefProperty or a node of a ListProperty. Rows are addressed
+ * by index, and change notifications are delivered for the whole column
+ * to the table. Types which need any of these stay regular Objects.
+ */
+class ColumnTable
+	: public Object
+{
+public:
+	ColumnTable() = default;
+
+	std::size_t Size() const;
+	void Resize(std::size_t rows);
+
+	/**
+	 * Appends default valued rows and returns the index of the first one.
+	 */
+	std::size_t AddRows(std::size_t count);
+
+private:
+	friend class ColumnBase;
+	void RegisterColumn(ColumnBase* column);
+
+	std::vector<ColumnBase*> columns_;
+};
+
+
+template<typename T>
+class Column
+	: public ColumnBase
+{
+public:
+	using const_iterator = typename std::vector<T>::const_iterator;
+
+	using ColumnBase::ColumnBase;
+
+	virtual std::size_t Size() const override;
+	virtual void Resize(std::size_t rows) override;
+	virtual std::uint64_t Hash() const override;
+	virtual void Spill(SpillWriter& writer) override;
+	virtual void Reload(SpillReader& reader) override;
+
+	const T& Get(std::size_t row) const;
+	const T& operator[](std::size_t row) const;
+	void Set(std::size_t row, T value);
+
+	const T* Data() const;
+	const_iterator begin() const;
+	const_iterator end() const;
+
+private:
+	class Change : public Command {
+	public:
+		Change(Column* column, std::size_t row, T value);
+		virtual void Apply(bool reverse) override;
+
+	private:
+		Column* column_;
+		std::size_t row_;
+		T value_;
+	};
+
+	/**
+	 * Swaps the number of rows, the removed rows are kept.
+	 */
+	class ResizeChange : public Command {
+	public:
+		ResizeChange(Column* column, std::size_t rows);
+		virtual void Apply(bool reverse) override;
+
+	private:
+		Column* column_;
+		std::size_t rows_;
+		std::vector<T> tail_;
+	};
+
+	std::vector<T> values_;
+};
+
+} // namespace undoable
+
+#include "undoable/ColumnTable-inl.h"
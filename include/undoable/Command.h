@@ -2,10 +2,59 @@
 
 namespace undoable {
 
+class SpillWriter;
+class SpillReader;
+class ThreadPool;
+
 class Command {
 public:
 	virtual ~Command() = default;
 	virtual void Apply(bool reverse) = 0;
+
+	/**
+	 * Called on the last command of a Transaction with the next, already
+	 * applied command. Returns true if the command was absorbed.
+	 */
+	virtual bool Merge(Command& command) { return false; }
+
+	/**
+	 * Identifies the class of a command, so Merge() can check the other
+	 * command without RTTI. Commands returning the same non-null tag have
+	 * the same type.
+	 */
+	virtual const void* Tag() const { return nullptr; }
+
+	/**
+	 * Called when transactions are squashed, after the merges. Commands
+	 * can drop state which is redundant for the whole transaction.
+	 */
+	virtual void Compact() {}
+
+	/**
+	 * Opt-in for parallel undo and redo. Commands returning the same
+	 * non-null partition touch the same state, ApplyPartitioned() of
+	 * other partitions may run concurrently. Notify() is called afterwards
+	 * on the calling thread, in the order of the Transaction.
+	 */
+	virtual const void* Partition() const { return nullptr; }
+	virtual void ApplyPartitioned(bool reverse) { Apply(reverse); }
+	virtual void Notify() {}
+
+	/**
+	 * Called instead of Apply() on commands without a partition during a
+	 * parallel undo or redo. Commands spanning several partitions, like
+	 * merged batches, can split their own work over the pool.
+	 */
+	virtual void ApplyParallel(bool reverse, ThreadPool& pool) {
+		Apply(reverse);
+	}
+
+	/**
+	 * Moves large payloads out of memory, when the Transaction is deep in
+	 * the Undo stack. Reload() reads back exactly what Spill() wrote.
+	 */
+	virtual void Spill(SpillWriter& writer) {}
+	virtual void Reload(SpillReader& reader) {}
 };
 
 } // namespace undoable
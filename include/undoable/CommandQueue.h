@@ -0,0 +1,74 @@
+#pragma once
+#include <atomic>
+#include <functional>
+#include <limits>
+#include <vector>
+#include "undoable/UniquePtr.h"
+#include "undoable/Command.h"
+#include "undoable/History.h"
+
+
+namespace undoable {
+
+/**
+ * Multi-producer queue of edit batches. Batches can be submitted from any
+ * thread without locking, and the thread owning the History applies each
+ * of them as a separate transaction.
+ */
+class CommandQueue {
+public:
+	class Batch {
+	public:
+		/**
+		 * Edits are applied on the owner thread in the order they were added.
+		 * Functions can call property setters, commands are staged directly.
+		 */
+		void Add(std::function<void()> edit);
+		void Add(UniquePtr<Command> command);
+		bool IsEmpty() const;
+
+	private:
+		friend class CommandQueue;
+
+		struct Edit {
+			std::function<void()> function;
+			UniquePtr<Command> command;
+		};
+
+		std::vector<Edit> edits_;
+	};
+
+	CommandQueue() = default;
+	~CommandQueue();
+	CommandQueue(const CommandQueue&) = delete;
+	CommandQueue& operator=(const CommandQueue&) = delete;
+
+	/**
+	 * Thread safe and lock-free.
+	 */
+	void Submit(Batch batch);
+
+	/**
+	 * Applies and commits at most `max_batches` batches in submission order
+	 * per producer. Does nothing if the History has pending changes.
+	 * Returns the number of applied batches.
+	 */
+	std::size_t Drain(History& history,
+		std::size_t max_batches=std::numeric_limits<std::size_t>::max());
+
+private:
+	struct Node {
+		Batch batch;
+		Node* next;
+	};
+
+	void TakeSubmitted();
+
+	// Note: producers push onto a lock-free stack, which is taken as
+	// a whole and reversed by the owner thread.
+	std::atomic<Node*> submitted_{nullptr};
+	Node* first_pending_ = nullptr;
+	Node* last_pending_ = nullptr;
+};
+
+} // namespace undoable
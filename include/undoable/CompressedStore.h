@@ -0,0 +1,53 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "undoable/Spill.h"
+
+
+namespace undoable {
+
+/**
+ * Keeps spilled transactions in memory as compressed byte buffers,
+ * as a cold tier for History::SetSpillStore().
+ *
+ * Only the spilled payloads are compressed, see Command::Spill(). The
+ * command objects, the first entry of each ValueProperty batch and the
+ * payloads which do not spill stay resident, so the reachable history
+ * depth grows by the compression ratio of the payloads only.
+ */
+class CompressedStore
+	: public SpillStore {
+public:
+	/**
+	 * Compressed and uncompressed number of bytes held by stored
+	 * transactions.
+	 */
+	std::uint64_t Size() const;
+	std::uint64_t RawSize() const;
+
+	virtual std::uint64_t Put(const std::vector<char>& bytes) override;
+	virtual std::vector<char> Take(std::uint64_t id) override;
+	virtual void Drop(std::uint64_t id) override;
+
+	static std::vector<char> Compress(const std::vector<char>& bytes);
+
+	/**
+	 * Throws std::runtime_error if the buffer is corrupted, i.e. it does
+	 * not decompress to exactly `raw_size` bytes.
+	 */
+	static std::vector<char> Decompress(
+		const std::vector<char>& bytes, std::size_t raw_size);
+
+private:
+	struct Entry {
+		std::vector<char> bytes;
+		std::size_t raw_size;
+	};
+
+	std::vector<Entry> entries_;
+	std::vector<std::uint64_t> free_ids_;
+	std::uint64_t size_ = 0;
+	std::uint64_t raw_size_ = 0;
+};
+
+} // namespace undoable
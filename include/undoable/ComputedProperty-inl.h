@@ -0,0 +1,34 @@
+#pragma once
+
+
+namespace undoable {
+
+// ComputedPropertyBase::Dependencies
+
+template<typename P>
+const P& ComputedPropertyBase::Dependencies::operator()(const P& property) {
+	Record(&property);
+	return property;
+}
+
+
+// ComputedProperty
+
+template<typename T>
+ComputedProperty<T>::ComputedProperty(PropertyOwner* owner, Function function)
+	: ComputedPropertyBase(owner)
+	, function_(std::move(function))
+	, value_()
+{}
+
+template<typename T>
+const T& ComputedProperty<T>::Get() const {
+	if (!IsValid()) {
+		Dependencies dependencies(owner_);
+		value_ = function_(dependencies);
+		Validate(dependencies);
+	}
+	return value_;
+}
+
+} // namespace undoable
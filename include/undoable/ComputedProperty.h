@@ -0,0 +1,76 @@
+#pragma once
+#include <functional>
+#include <vector>
+#include "undoable/Property.h"
+
+
+namespace undoable {
+
+class ComputedPropertyBase;
+
+template<typename T> class ComputedProperty;
+
+
+class ComputedPropertyBase
+	: public Property
+{
+public:
+	/**
+	 * Records the properties read by the compute function. Properties of
+	 * fragments are recorded as the fragment of the owner containing them.
+	 */
+	class Dependencies {
+	public:
+		explicit Dependencies(const PropertyOwner* owner);
+		template<typename P> const P& operator()(const P& property);
+
+	private:
+		friend class ComputedPropertyBase;
+		void Record(const Property* property);
+
+		const PropertyOwner* owner_;
+		std::vector<const Property*> properties_;
+	};
+
+	ComputedPropertyBase(PropertyOwner* owner);
+	virtual void OnReset() override {}
+	virtual void OnDependencyChange(Property* property) override;
+
+	bool IsValid() const;
+	void Invalidate();
+
+protected:
+	void Validate(Dependencies& dependencies) const;
+
+private:
+	mutable std::vector<const Property*> dependencies_;
+	mutable bool valid_ = false;
+};
+
+
+/**
+ * Value derived from other properties of the same owner, including the
+ * properties of its fragments. It is invalidated when any property read
+ * by the compute function changes, and recomputed on the next access.
+ * Properties of other objects cannot be read through Dependencies, their
+ * changes have to be propagated by calling Invalidate().
+ */
+template<typename T>
+class ComputedProperty
+	: public ComputedPropertyBase
+{
+public:
+	using Function = std::function<T(Dependencies&)>;
+
+	ComputedProperty(PropertyOwner* owner, Function function);
+
+	const T& Get() const;
+
+private:
+	Function function_;
+	mutable T value_;
+};
+
+} // namespace undoable
+
+#include "undoable/ComputedProperty-inl.h"
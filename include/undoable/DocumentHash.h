@@ -0,0 +1,58 @@
+#pragma once
+#include <cstdint>
+#include <unordered_map>
+#include "undoable/History.h"
+
+
+namespace undoable {
+
+class Factory;
+class Object;
+
+/**
+ * Content hash of all created objects of a Factory. It is updated from
+ * the change sets of the History, so it reflects the state after the last
+ * Commit, Undo, Redo or Unstage.
+ *
+ * The hash of every property is cached, and only modified properties are
+ * hashed again, so maintenance costs O(changes) plus the size of the
+ * modified properties. Properties and objects are combined by summing, so
+ * the same state yields the same hash regardless of the order of the
+ * changes. Objects, references and
+ * list nodes are identified by their address, so the hash detects changes
+ * of one document, but cannot compare two replicas of it.
+ */
+class DocumentHash
+	: public ChangeListener
+{
+public:
+	DocumentHash(Factory& factory);
+	~DocumentHash();
+	DocumentHash(const DocumentHash&) = delete;
+	DocumentHash& operator=(const DocumentHash&) = delete;
+
+	std::uint64_t Get() const;
+	std::uint64_t GetObjectHash(Object* object) const;
+
+	virtual void OnChanges(const ChangeSet& changes) override;
+
+private:
+	struct Entry {
+		Object* object;
+		std::uint64_t hash;
+	};
+
+	void Add(Object* object);
+	void Remove(Object* object);
+	void Update(Property* property);
+	static std::uint64_t Contribution(const void* key, std::uint64_t hash);
+
+	History& history_;
+	std::unordered_map<Object*, std::uint64_t> objects_;
+	// Note: only properties registered directly on objects are cached,
+	// changes of fragment members update their fragment.
+	std::unordered_map<const Property*, Entry> properties_;
+	std::uint64_t hash_ = 0;
+};
+
+} // namespace undoable
@@ -11,8 +11,74 @@ Type& Factory::Create(Args&&... args) {
 
 	Type* obj = new Type(args...);
 	LinkBack(obj);
-	obj->Init(&history_);
+	if (defer_on_create_) {
+		deferred_.push_back(obj);
+	} else {
+		obj->Init(&history_);
+	}
 	return *obj;
 }
 
+template<typename Type, typename Init>
+std::vector<Type*> Factory::CreateMany(std::size_t count, Init init) {
+	static_assert(
+		std::is_base_of<Object, Type>::value,
+		"Missing base class");
+
+	std::vector<Type*> objs;
+	objs.reserve(count);
+	for (std::size_t i = 0; i < count; ++i) {
+		objs.push_back(new Type());
+	}
+	if (objs.empty()) {
+		return objs;
+	}
+
+	// Note: the objects are linked as a chain first, since `init` might
+	// create other objects.
+	for (std::size_t i = 1; i < count; ++i) {
+		ObjectBase::Link(objs[i - 1], objs[i]);
+	}
+	ObjectBase::Link(head_.prev_object_, objs.front());
+	ObjectBase::Link(objs.back(), &head_);
+
+	if (defer_on_create_) {
+		for (std::size_t i = 0; i < count; ++i) {
+			init(*objs[i], i);
+		}
+		deferred_.insert(deferred_.end(), objs.begin(), objs.end());
+		return objs;
+	}
+
+	// Note: `init` runs after the creation is staged, so that changes
+	// touching other objects, e.g. references, are undone with it.
+	std::vector<Object*> created(objs.begin(), objs.end());
+	for (auto* obj : created) {
+		obj->SetHistory(&history_);
+	}
+	history_.Stage(MakeUnique<Object::BatchStatusChange>(
+		std::move(created), true));
+
+	for (std::size_t i = 0; i < count; ++i) {
+		init(*objs[i], i);
+	}
+	return objs;
+}
+
+template<typename Range>
+void Factory::DestroyMany(const Range& objects) {
+	std::vector<Object*> objs;
+	for (auto* obj : objects) {
+		objs.push_back(obj);
+	}
+	DestroyObjects(std::move(objs));
+}
+
+template<typename Fn>
+void Factory::ForEachObject(Fn fn) {
+	for (auto* p = head_.next_object_; p != &head_; p = p->next_object_) {
+		fn(static_cast<Object*>(p));
+	}
+}
+
 } // namespace undoable
@@ -1,23 +1,78 @@
 #pragma once
+#include <vector>
 #include "undoable/Object.h"
 #include "undoable/History.h"
 
 namespace undoable {
 
+class Builder;
+
 class Factory {
 public:
+	/**
+	 * Scoped bulk load, see History::BeginBulkLoad(). With `defer_on_create`
+	 * OnCreate() of the new objects is called at the end of the scope, and
+	 * until then they behave like objects of a Builder.
+	 */
+	class BulkLoad {
+	public:
+		explicit BulkLoad(Factory& factory, bool defer_on_create=false);
+		~BulkLoad();
+		BulkLoad(const BulkLoad&) = delete;
+		BulkLoad& operator=(const BulkLoad&) = delete;
+
+	private:
+		Factory& factory_;
+	};
+
 	Factory() = default;
 	~Factory();
 
 	template<typename Type, typename... Args> Type& Create(Args&&... args);
 	History& GetHistory();
 
+	/**
+	 * Creates `count` default constructed objects, and stages their
+	 * creation as a single command. `init(object, index)` is called
+	 * after OnCreate(), property changes are staged like after Create().
+	 * During a deferred BulkLoad it is called before OnCreate(), and
+	 * changes are applied in place.
+	 */
+	template<typename Type, typename Init>
+	std::vector<Type*> CreateMany(std::size_t count, Init init);
+
+	/**
+	 * Destroys a range of object pointers with a single lifecycle command.
+	 * Lists and references between the destroyed objects are reset only
+	 * once, by their owners. Objects which are not created are ignored.
+	 * The member resets are still staged as a group of their own commands
+	 * before the lifecycle command, and objects destroyed by an owning
+	 * property go through Object::Destroy() one by one.
+	 */
+	template<typename Range> void DestroyMany(const Range& objects);
+
+	/**
+	 * Takes over all objects of the builder, and stages their creation
+	 * as a single command.
+	 */
+	void Attach(Builder& builder);
+
+	/**
+	 * Calls `fn` with every object, including destroyed ones which are
+	 * kept alive by the history.
+	 */
+	template<typename Fn> void ForEachObject(Fn fn);
+
 private:
+	void DestroyObjects(std::vector<Object*> objs);
 	void LinkBack(ObjectBase* node);
 	Object* NextObject();
 
 	History history_;
 	ObjectBase head_;
+
+	bool defer_on_create_ = false;
+	std::vector<Object*> deferred_;
 };
 
 } // namespace undoable
@@ -11,9 +11,21 @@ public:
 	Fragment(PropertyOwner* owner);
 	~Fragment();
 
+	// Note: the version of the fragment is the same as a property and
+	// as an owner, and it is propagated to the owner.
+	using Property::Version;
+
 	virtual void OnReset() override;
+	virtual std::uint64_t Hash() const override;
+	virtual void Capture(Captures& captures) const override;
+	virtual void Spill(SpillWriter& writer) override;
+	virtual void Reload(SpillReader& reader) override;
 	virtual void OnPropertyChange(Property* property) override;
 	virtual void ApplyPropertyChange(UniquePtr<Command> command) override;
+	virtual void TrackPropertyChange(Property* property) override;
+
+protected:
+	virtual void IncrementVersion() override;
 };
 
 } // namespace undoable
@@ -0,0 +1,178 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+
+namespace undoable {
+
+inline std::uint64_t HashMix(std::uint64_t h) {
+	h ^= h >> 33;
+	h *= 0xff51afd7ed558ccdull;
+	h ^= h >> 33;
+	h *= 0xc4ceb9fe1a85ec53ull;
+	h ^= h >> 33;
+	return h;
+}
+
+inline std::uint64_t HashCombine(std::uint64_t seed, std::uint64_t value) {
+	return HashMix(seed ^ (value + 0x9e3779b97f4a7c15ull + (seed << 6)));
+}
+
+inline std::uint64_t HashBytes(const void* data, std::size_t size) {
+	auto bytes = static_cast<const unsigned char*>(data);
+	std::uint64_t h = HashMix(size);
+	while (size >= sizeof(std::uint64_t)) {
+		std::uint64_t word;
+		std::memcpy(&word, bytes, sizeof(word));
+		h = HashCombine(h, word);
+		bytes += sizeof(word);
+		size -= sizeof(word);
+	}
+	if (size > 0) {
+		std::uint64_t word = 0;
+		std::memcpy(&word, bytes, size);
+		h = HashCombine(h, word);
+	}
+	return h;
+}
+
+/**
+ * Values are hashable if they have a std::hash, if they are ranges or pairs
+ * of hashable values, or if they are trivially copyable, which are hashed
+ * by their bytes. Overload HashValue() in the namespace of a type to make
+ * it hashable or to customize it, e.g. for structs with padding, whose
+ * padding bytes would take part in the byte hash.
+ *
+ * Pointers are hashed by address, so hashes are only comparable within
+ * the process that computed them.
+ */
+template<typename T, typename = void>
+struct IsHashable;
+
+namespace detail {
+
+template<typename...>
+struct Void {
+	using type = void;
+};
+
+template<typename T, typename = void>
+struct HasStdHash : std::false_type {};
+
+template<typename T>
+struct HasStdHash<T, typename Void<
+	decltype(std::hash<T>()(std::declval<const T&>()))>::type>
+	: std::true_type {};
+
+template<typename T, typename = void>
+struct IsRange : std::false_type {};
+
+template<typename T>
+struct IsRange<T, typename Void<
+	decltype(std::begin(std::declval<const T&>())),
+	decltype(std::end(std::declval<const T&>()))>::type>
+	: std::true_type {};
+
+template<typename T, bool = IsRange<T>::value>
+struct IsHashableRange : std::false_type {};
+
+template<typename T>
+struct IsHashableRange<T, true>
+	: IsHashable<typename std::decay<
+		decltype(*std::begin(std::declval<const T&>()))>::type> {};
+
+} // namespace detail
+
+template<typename T>
+auto HashValue(const T& value)
+	-> typename std::enable_if<detail::HasStdHash<T>::value,
+		std::uint64_t>::type;
+
+template<typename T>
+auto HashValue(const T& value)
+	-> typename std::enable_if<!detail::HasStdHash<T>::value &&
+		detail::IsHashableRange<T>::value, std::uint64_t>::type;
+
+template<typename T>
+auto HashValue(const T& value)
+	-> typename std::enable_if<!detail::HasStdHash<T>::value &&
+		!detail::IsRange<T>::value && std::is_trivially_copyable<T>::value,
+		std::uint64_t>::type;
+
+template<typename First, typename Second>
+auto HashValue(const std::pair<First, Second>& value)
+	-> typename std::enable_if<IsHashable<First>::value &&
+		IsHashable<Second>::value, std::uint64_t>::type;
+
+template<typename T, typename>
+struct IsHashable : std::false_type {};
+
+template<typename T>
+struct IsHashable<T, typename detail::Void<
+	decltype(HashValue(std::declval<const T&>()))>::type>
+	: std::true_type {};
+
+/**
+ * Used by properties, which can hold any value. Values which are not
+ * hashable all hash to kUnhashable, so DocumentHash does not see their
+ * changes.
+ */
+const std::uint64_t kUnhashable = 0x5bd1e9955bd1e995ull;
+
+template<typename T>
+auto TryHashValue(const T& value)
+	-> typename std::enable_if<IsHashable<T>::value, std::uint64_t>::type
+{
+	return HashValue(value);
+}
+
+template<typename T>
+auto TryHashValue(const T& value)
+	-> typename std::enable_if<!IsHashable<T>::value, std::uint64_t>::type
+{
+	return kUnhashable;
+}
+
+
+template<typename T>
+auto HashValue(const T& value)
+	-> typename std::enable_if<detail::HasStdHash<T>::value,
+		std::uint64_t>::type
+{
+	return HashMix(std::hash<T>()(value));
+}
+
+template<typename T>
+auto HashValue(const T& value)
+	-> typename std::enable_if<!detail::HasStdHash<T>::value &&
+		detail::IsHashableRange<T>::value, std::uint64_t>::type
+{
+	std::uint64_t h = 0;
+	for (auto& item : value) {
+		h = HashCombine(h, HashValue(item));
+	}
+	return h;
+}
+
+template<typename T>
+auto HashValue(const T& value)
+	-> typename std::enable_if<!detail::HasStdHash<T>::value &&
+		!detail::IsRange<T>::value && std::is_trivially_copyable<T>::value,
+		std::uint64_t>::type
+{
+	return HashBytes(&value, sizeof(value));
+}
+
+template<typename First, typename Second>
+auto HashValue(const std::pair<First, Second>& value)
+	-> typename std::enable_if<IsHashable<First>::value &&
+		IsHashable<Second>::value, std::uint64_t>::type
+{
+	return HashCombine(HashValue(value.first), HashValue(value.second));
+}
+
+} // namespace undoable
@@ -0,0 +1,197 @@
+#pragma once
+#include <cassert>
+#include <cstdint>
+
+
+namespace undoable {
+
+// HashTable::const_iterator
+
+template<typename Key, typename Value, typename Hash>
+HashTable<Key, Value, Hash>::const_iterator::const_iterator(
+		const Slot* slot, const Slot* end)
+	: slot_(slot)
+	, end_(end)
+{
+	SkipUnused();
+}
+
+template<typename Key, typename Value, typename Hash>
+void HashTable<Key, Value, Hash>::const_iterator::SkipUnused() {
+	while (slot_ != end_ && !slot_->used) {
+		++slot_;
+	}
+}
+
+template<typename Key, typename Value, typename Hash>
+typename HashTable<Key, Value, Hash>::const_iterator&
+HashTable<Key, Value, Hash>::const_iterator::operator++() {
+	++slot_;
+	SkipUnused();
+	return *this;
+}
+
+template<typename Key, typename Value, typename Hash>
+typename HashTable<Key, Value, Hash>::const_iterator
+HashTable<Key, Value, Hash>::const_iterator::operator++(int) {
+	auto it = *this;
+	++*this;
+	return it;
+}
+
+template<typename Key, typename Value, typename Hash>
+bool HashTable<Key, Value, Hash>::const_iterator::operator==(
+	const const_iterator& other) const
+{
+	return slot_ == other.slot_;
+}
+
+template<typename Key, typename Value, typename Hash>
+bool HashTable<Key, Value, Hash>::const_iterator::operator!=(
+	const const_iterator& other) const
+{
+	return slot_ != other.slot_;
+}
+
+template<typename Key, typename Value, typename Hash>
+const typename HashTable<Key, Value, Hash>::Entry&
+HashTable<Key, Value, Hash>::const_iterator::operator*() const {
+	return slot_->entry;
+}
+
+template<typename Key, typename Value, typename Hash>
+const typename HashTable<Key, Value, Hash>::Entry*
+HashTable<Key, Value, Hash>::const_iterator::operator->() const {
+	return &slot_->entry;
+}
+
+
+// HashTable
+
+template<typename Key, typename Value, typename Hash>
+std::size_t HashTable<Key, Value, Hash>::Size() const {
+	return size_;
+}
+
+template<typename Key, typename Value, typename Hash>
+bool HashTable<Key, Value, Hash>::IsEmpty() const {
+	return size_ == 0;
+}
+
+template<typename Key, typename Value, typename Hash>
+Value* HashTable<Key, Value, Hash>::Find(const Key& key) {
+	if (size_ == 0) {
+		return nullptr;
+	}
+	auto& slot = slots_[Probe(key)];
+	return slot.used ? &slot.entry.second : nullptr;
+}
+
+template<typename Key, typename Value, typename Hash>
+const Value* HashTable<Key, Value, Hash>::Find(const Key& key) const {
+	return const_cast<HashTable*>(this)->Find(key);
+}
+
+template<typename Key, typename Value, typename Hash>
+Value& HashTable<Key, Value, Hash>::Insert(Key key, Value value) {
+	// Note: the load factor is kept at or below 3/4
+	if (4 * (size_ + 1) > 3 * slots_.size()) {
+		Grow();
+	}
+
+	auto& slot = slots_[Probe(key)];
+	assert(!slot.used && "Key is already in the table");
+	slot.used = true;
+	slot.entry.first = std::move(key);
+	slot.entry.second = std::move(value);
+	++size_;
+	return slot.entry.second;
+}
+
+template<typename Key, typename Value, typename Hash>
+bool HashTable<Key, Value, Hash>::Erase(const Key& key) {
+	if (size_ == 0) {
+		return false;
+	}
+	auto index = Probe(key);
+	if (!slots_[index].used) {
+		return false;
+	}
+	EraseAt(index);
+	return true;
+}
+
+template<typename Key, typename Value, typename Hash>
+void HashTable<Key, Value, Hash>::Swap(HashTable& other) {
+	std::swap(slots_, other.slots_);
+	std::swap(size_, other.size_);
+	std::swap(mask_, other.mask_);
+}
+
+template<typename Key, typename Value, typename Hash>
+typename HashTable<Key, Value, Hash>::const_iterator
+HashTable<Key, Value, Hash>::begin() const {
+	return const_iterator(slots_.data(), slots_.data() + slots_.size());
+}
+
+template<typename Key, typename Value, typename Hash>
+typename HashTable<Key, Value, Hash>::const_iterator
+HashTable<Key, Value, Hash>::end() const {
+	auto* end = slots_.data() + slots_.size();
+	return const_iterator(end, end);
+}
+
+template<typename Key, typename Value, typename Hash>
+std::size_t HashTable<Key, Value, Hash>::Ideal(const Key& key) const {
+	// Note: std::hash is the identity for integers on most platforms,
+	// so the bits are mixed before masking.
+	std::uint64_t h = Hash()(key);
+	h *= 0x9e3779b97f4a7c15ull;
+	return static_cast<std::size_t>(h ^ (h >> 32)) & mask_;
+}
+
+template<typename Key, typename Value, typename Hash>
+std::size_t HashTable<Key, Value, Hash>::Probe(const Key& key) const {
+	auto index = Ideal(key);
+	while (slots_[index].used && !(slots_[index].entry.first == key)) {
+		index = (index + 1) & mask_;
+	}
+	return index;
+}
+
+template<typename Key, typename Value, typename Hash>
+void HashTable<Key, Value, Hash>::EraseAt(std::size_t index) {
+	slots_[index].used = false;
+	slots_[index].entry = Entry();
+	--size_;
+
+	// Shift back the following entries whose probe sequence passes `index`
+	for (auto next = (index + 1) & mask_; slots_[next].used;
+		next = (next + 1) & mask_)
+	{
+		auto ideal = Ideal(slots_[next].entry.first);
+		if (((next - ideal) & mask_) >= ((next - index) & mask_)) {
+			slots_[index].used = true;
+			slots_[index].entry = std::move(slots_[next].entry);
+			slots_[next].used = false;
+			slots_[next].entry = Entry();
+			index = next;
+		}
+	}
+}
+
+template<typename Key, typename Value, typename Hash>
+void HashTable<Key, Value, Hash>::Grow() {
+	std::vector<Slot> slots(slots_.empty() ? 8 : 2 * slots_.size());
+	std::swap(slots, slots_);
+	mask_ = slots_.size() - 1;
+	size_ = 0;
+
+	for (auto& slot : slots) {
+		if (slot.used) {
+			Insert(std::move(slot.entry.first), std::move(slot.entry.second));
+		}
+	}
+}
+
+} // namespace undoable
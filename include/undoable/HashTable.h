@@ -0,0 +1,79 @@
+#pragma once
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+
+namespace undoable {
+
+/**
+ * Open-addressing hash table with linear probing and backward-shift
+ * deletion, so there are no tombstones. Keys and values need to be
+ * default constructible and movable.
+ */
+template<typename Key, typename Value, typename Hash=std::hash<Key>>
+class HashTable {
+private:
+	struct Slot {
+		bool used = false;
+		std::pair<Key, Value> entry;
+	};
+
+public:
+	using Entry = std::pair<Key, Value>;
+
+	class const_iterator
+		: public std::iterator<std::forward_iterator_tag, const Entry>
+	{
+	public:
+		const_iterator() = default;
+		const_iterator& operator++();
+		const_iterator operator++(int);
+		bool operator==(const const_iterator& other) const;
+		bool operator!=(const const_iterator& other) const;
+		const Entry& operator*() const;
+		const Entry* operator->() const;
+
+	private:
+		friend class HashTable;
+		const_iterator(const Slot* slot, const Slot* end);
+		void SkipUnused();
+
+		const Slot* slot_ = nullptr;
+		const Slot* end_ = nullptr;
+	};
+
+	HashTable() = default;
+
+	std::size_t Size() const;
+	bool IsEmpty() const;
+
+	Value* Find(const Key& key);
+	const Value* Find(const Key& key) const;
+
+	/**
+	 * Inserts a key that is not yet in the table.
+	 */
+	Value& Insert(Key key, Value value);
+	bool Erase(const Key& key);
+	void Swap(HashTable& other);
+
+	const_iterator begin() const;
+	const_iterator end() const;
+
+private:
+	std::size_t Ideal(const Key& key) const;
+	std::size_t Probe(const Key& key) const;
+	void EraseAt(std::size_t index);
+	void Grow();
+
+	std::vector<Slot> slots_;
+	std::size_t size_ = 0;
+	std::size_t mask_ = 0;
+};
+
+} // namespace undoable
+
+#include "undoable/HashTable-inl.h"
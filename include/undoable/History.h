@@ -1,5 +1,11 @@
 #pragma once
+#include <chrono>
+#include <cstdint>
 #include <list>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
 #include "undoable/UniquePtr.h"
 #include "undoable/Command.h"
 
@@ -7,6 +13,35 @@ namespace undoable {
 
 class Transaction;
 class History;
+class ChangeListener;
+class Object;
+class Property;
+class ThreadPool;
+class SpillStore;
+
+
+/**
+ * Net changes of a Commit, Undo, Redo or Unstage. Objects which were
+ * created and destroyed within the same change set are left out.
+ */
+struct ChangeSet {
+	std::vector<Object*> created;
+	std::vector<Object*> destroyed;
+	std::vector<Property*> modified;
+
+	// Objects with modified properties, which are neither created
+	// nor destroyed in the change set.
+	std::vector<Object*> changed;
+
+	bool IsEmpty() const;
+};
+
+
+class ChangeListener {
+public:
+	virtual ~ChangeListener() = default;
+	virtual void OnChanges(const ChangeSet& changes) = 0;
+};
 
 
 class Transaction {
@@ -14,23 +49,80 @@ public:
 	Transaction() = default;
 	~Transaction();
 	Transaction(const Transaction&) = delete;
-	Transaction(Transaction&&) = default;
+	Transaction(Transaction&& other);
 	Transaction& operator=(const Transaction&) = delete;
-	Transaction& operator=(Transaction&&) = default;
+	Transaction& operator=(Transaction&& other);
 
 	bool IsEmpty() const;
 	void Apply(UniquePtr<Command> command);
-	void Reverse();
 	void Clear();
 
+	/**
+	 * Destroys at most `count` commands, in the same order as Clear().
+	 * Returns true if the transaction became empty.
+	 */
+	bool ClearFront(std::size_t count);
+
+	std::size_t Size() const;
+
+	/**
+	 * Commands applied so far are not merged with later ones.
+	 */
+	void Seal();
+
+	/**
+	 * Reverts and destroys the commands after the first `size` ones.
+	 */
+	void Truncate(std::size_t size);
+
+	/**
+	 * Appends the commands of a later transaction, merging adjacent
+	 * commands where possible.
+	 */
+	void Append(Transaction other);
+
+	/**
+	 * Calls Command::Compact() on the commands.
+	 */
+	void Compact();
+
+	/**
+	 * Applies the commands in reverse order. With a pool, long runs of
+	 * partitioned commands are applied in parallel and notified afterwards.
+	 */
+	void Reverse(ThreadPool* pool=nullptr);
+
+	/**
+	 * Moves the payloads of the commands to the store. Spilled transactions
+	 * are reloaded when they are reversed. Nothing is stored if the
+	 * commands have no payload, but the transaction still counts as spilled.
+	 */
+	void Spill(SpillStore& store);
+	void Reload();
+	bool IsSpilled() const;
+
+	/**
+	 * Spills and reloads the payloads of the commands in place, used for
+	 * transactions nested in other commands.
+	 */
+	void Spill(SpillWriter& writer);
+	void Reload(SpillReader& reader);
+
 private:
+	void ApplyRun(const std::vector<Command*>& run, ThreadPool& pool);
+
 	// Note: Commands are stored in the order they were applied.
 	std::list<UniquePtr<Command>> commands_;
 	bool reverse_ = false;
+	std::size_t sealed_ = 0;
+	bool spilled_ = false;
+	SpillStore* store_ = nullptr;
+	std::uint64_t spill_id_ = 0;
 };
 
 
-class History {
+// Note: the alignment leaves room for tag bits in History pointers.
+class alignas(8) History {
 public:
 	~History();
 
@@ -44,6 +136,13 @@ public:
 	 */
 	void Stage(UniquePtr<Command> command);
 
+	/**
+	 * Stages a command which destroys objects. While bulk loading it is
+	 * applied in place but kept until EndBulkLoad() has delivered the
+	 * changes, so the destroyed objects are not deleted before that.
+	 */
+	void StageDestroy(UniquePtr<Command> command);
+
 	/**
 	 * Reverts pending changes.
 	 */
@@ -54,6 +153,17 @@ public:
 	 */
 	void Commit();
 
+	/**
+	 * Savepoints of the pending changes. RollbackTo() reverts the changes
+	 * staged after the savepoint and keeps it, Release() keeps the changes.
+	 * Savepoints are nested, inner ones are released with outer ones.
+	 * Not allowed during a bulk load or a group. As with Unstage(), the
+	 * reverted properties are still reported as modified to listeners.
+	 */
+	std::size_t Mark();
+	void RollbackTo(std::size_t savepoint);
+	void Release(std::size_t savepoint);
+
 	/**
 	 * If there are no pending changes then restores the previous commit point.
 	 */
@@ -64,6 +174,18 @@ public:
 	 */
 	void Redo();
 
+	/**
+	 * Number of commits on the Undo stack. Revision 0 is the oldest state
+	 * which can be restored.
+	 */
+	std::size_t Revision() const;
+
+	/**
+	 * Replaces the commits between revisions `from` and `to` with a single
+	 * one, so they are undone and redone in one step.
+	 */
+	void Squash(std::size_t from, std::size_t to);
+
 	/**
 	 * True, if the Undo stack is not empty, and there are no pending changes.
 	 */
@@ -79,9 +201,111 @@ public:
 	 */
 	bool CanCommit() const;
 
+	/**
+	 * Listeners receive a ChangeSet once after every Commit, Undo, Redo
+	 * and Unstage. Changes are only tracked while there are listeners.
+	 */
+	void AddListener(ChangeListener* listener);
+	void RemoveListener(ChangeListener* listener);
+
+	/**
+	 * Called by objects when commands are applied.
+	 */
+	void TrackCreate(Object* object);
+	void TrackDestroy(Object* object);
+	void TrackChange(Object* object, Property* property);
+
+	/**
+	 * Opt-in parallel Undo, Redo and Unstage, see Command::Partition().
+	 * The pool is not owned, nullptr restores sequential application.
+	 */
+	void SetThreadPool(ThreadPool* pool);
+
+	/**
+	 * Commands staged between BeginGroup() and EndGroup() are staged
+	 * as a single command. Groups cannot be nested.
+	 */
+	void BeginGroup();
+	void EndGroup();
+
+	/**
+	 * When deferred, transactions discarded by Commit and Clear are queued
+	 * instead of being destroyed right away, so their cost (including the
+	 * deletion of destroyed objects) is paid by Reclaim() calls.
+	 */
+	void SetDeferredReclaim(bool deferred);
+
+	/**
+	 * Transactions of the Undo stack below the `hot_depth` most recent ones
+	 * are spilled to the store. The store is not owned, and it has to
+	 * outlive the History. nullptr stops spilling.
+	 */
+	void SetSpillStore(SpillStore* store, std::size_t hot_depth);
+
+	/**
+	 * Destroys queued transactions until the budget is used up.
+	 * Returns true if the queue is empty.
+	 */
+	bool Reclaim(std::chrono::microseconds budget);
+	void ReclaimAll();
+
+	/**
+	 * While bulk loading, staged commands are applied in place and dropped,
+	 * so there is nothing to commit or undo. Begin clears the history,
+	 * End delivers the changes of the whole load as a single ChangeSet.
+	 * Objects destroyed during the load are deleted after the delivery.
+	 */
+	void BeginBulkLoad();
+	void EndBulkLoad();
+	bool IsBulkLoading() const;
+
 private:
+	/**
+	 * Commands which were applied when they were grouped.
+	 */
+	class Group : public Command {
+	public:
+		explicit Group(Transaction transaction);
+		virtual void Apply(bool reverse) override;
+		virtual void Spill(SpillWriter& writer) override;
+		virtual void Reload(SpillReader& reader) override;
+
+	private:
+		Transaction transaction_;
+		bool applied_ = true;
+	};
+
+	struct ObjectChange {
+		bool existed;
+		bool exists;
+	};
+
 	void ClearUndo();
 	void ClearRedo();
+	void Discard(std::list<Transaction>& list,
+		std::list<Transaction>::iterator it);
+	void SpillCold();
+	void TrackStatus(Object* object, bool exists);
+	void DeliverChanges();
+
+	std::vector<ChangeListener*> listeners_;
+	std::vector<Object*> changed_objects_;
+	std::unordered_map<Object*, ObjectChange> object_changes_;
+	std::vector<std::pair<Object*, Property*>> changed_properties_;
+	std::unordered_set<Property*> property_changes_;
+
+	ThreadPool* pool_ = nullptr;
+	bool bulk_load_ = false;
+	std::vector<UniquePtr<Command>> bulk_destroyed_;
+	std::vector<std::size_t> savepoints_;
+	bool grouping_ = false;
+	Transaction group_;
+
+	SpillStore* spill_store_ = nullptr;
+	std::size_t hot_depth_ = 0;
+
+	bool deferred_reclaim_ = false;
+	std::list<Transaction> reclaim_;
 
 	std::list<Transaction> undo_;
 	std::list<Transaction> redo_;
@@ -136,6 +136,15 @@ void ListProperty<Type, Tag>::OnReset() {
 	Clear();
 }
 
+template<typename Type, typename Tag>
+void ListProperty<Type, Tag>::Capture(Captures& captures) const {
+	auto items = std::make_shared<std::vector<const Type*>>();
+	for (auto& item : *this) {
+		items->push_back(&item);
+	}
+	captures.emplace_back(this, std::move(items));
+}
+
 template<typename Type, typename Tag>
 void ListProperty<Type, Tag>::UnlinkFront() {
 	ListNode::Next(Head()).Unlink();
@@ -1,6 +1,7 @@
 #pragma once
 #include <iterator>
 #include <type_traits>
+#include <unordered_set>
 #include <vector>
 #include "undoable/Property.h"
 #include "undoable/Command.h"
@@ -50,6 +51,7 @@ protected:
 
 private:
 	friend class ListNodeOwner;
+	friend class ListPropertyBase;
 	ListNodeBase* next_node_ = nullptr;
 };
 
@@ -59,8 +61,15 @@ public:
 	void RegisterListNode(ListNodeBase* node);
 	void UnlinkAllNodes();
 
+	/**
+	 * Like UnlinkAllNodes(), but keeps nodes in lists of the given owners.
+	 */
+	void UnlinkNodesExcept(
+		const std::unordered_set<const PropertyOwner*>& owners);
+
 private:
-	ListNodeBase* first_node_ = nullptr;
+	// Note: nodes form a circular list, the first one is
+	// `last_node_->next_node_`.
 	ListNodeBase* last_node_ = nullptr;
 };
 
@@ -128,6 +137,7 @@ class ListPropertyBase
 {
 public:
 	ListPropertyBase(PropertyOwner* owner);
+	virtual std::uint64_t Hash() const override;
 
 protected:
 	friend class ListNodeBase;
@@ -149,6 +159,7 @@ public:
 	ListProperty(PropertyOwner* owner);
 	~ListProperty();
 	virtual void OnReset() override;
+	virtual void Capture(Captures& captures) const override;
 
 	// O(1)
 	void UnlinkFront();
@@ -0,0 +1,160 @@
+#pragma once
+#include <cassert>
+
+
+namespace undoable {
+
+template<typename Key, typename Value, typename KeyHash>
+MapProperty<Key, Value, KeyHash>::MapProperty(PropertyOwner* owner)
+	: Property(owner)
+{}
+
+template<typename Key, typename Value, typename KeyHash>
+std::uint64_t MapProperty<Key, Value, KeyHash>::Hash() const {
+	// Note: the entries are summed, so the order of the slots does not matter
+	std::uint64_t h = 0;
+	for (auto& entry : table_) {
+		h += HashCombine(
+			TryHashValue(entry.first), TryHashValue(entry.second));
+	}
+	return h;
+}
+
+template<typename Key, typename Value, typename KeyHash>
+std::size_t MapProperty<Key, Value, KeyHash>::Size() const {
+	return table_.Size();
+}
+
+template<typename Key, typename Value, typename KeyHash>
+bool MapProperty<Key, Value, KeyHash>::IsEmpty() const {
+	return table_.IsEmpty();
+}
+
+template<typename Key, typename Value, typename KeyHash>
+bool MapProperty<Key, Value, KeyHash>::Contains(const Key& key) const {
+	return !!table_.Find(key);
+}
+
+template<typename Key, typename Value, typename KeyHash>
+const Value* MapProperty<Key, Value, KeyHash>::Find(const Key& key) const {
+	return table_.Find(key);
+}
+
+template<typename Key, typename Value, typename KeyHash>
+const Value& MapProperty<Key, Value, KeyHash>::At(const Key& key) const {
+	auto* value = table_.Find(key);
+	assert(value && "Key is not present");
+	return *value;
+}
+
+template<typename Key, typename Value, typename KeyHash>
+bool MapProperty<Key, Value, KeyHash>::Insert(Key key, Value value) {
+	if (table_.Find(key)) {
+		return false;
+	}
+	auto cmd = MakeUnique<Change>(this, std::move(key), std::move(value), true);
+	owner_->ApplyPropertyChange(std::move(cmd));
+	return true;
+}
+
+template<typename Key, typename Value, typename KeyHash>
+void MapProperty<Key, Value, KeyHash>::Assign(Key key, Value value) {
+	auto* current = table_.Find(key);
+	if (!current || value != *current) {
+		auto cmd = MakeUnique<Change>(
+			this, std::move(key), std::move(value), true);
+		owner_->ApplyPropertyChange(std::move(cmd));
+	}
+}
+
+template<typename Key, typename Value, typename KeyHash>
+bool MapProperty<Key, Value, KeyHash>::Erase(const Key& key) {
+	if (!table_.Find(key)) {
+		return false;
+	}
+	auto cmd = MakeUnique<Change>(this, key, Value(), false);
+	owner_->ApplyPropertyChange(std::move(cmd));
+	return true;
+}
+
+template<typename Key, typename Value, typename KeyHash>
+void MapProperty<Key, Value, KeyHash>::Clear() {
+	if (!table_.IsEmpty()) {
+		auto cmd = MakeUnique<ReplaceAll>(this);
+		owner_->ApplyPropertyChange(std::move(cmd));
+	}
+}
+
+template<typename Key, typename Value, typename KeyHash>
+typename MapProperty<Key, Value, KeyHash>::const_iterator
+MapProperty<Key, Value, KeyHash>::begin() const {
+	return table_.begin();
+}
+
+template<typename Key, typename Value, typename KeyHash>
+typename MapProperty<Key, Value, KeyHash>::const_iterator
+MapProperty<Key, Value, KeyHash>::end() const {
+	return table_.end();
+}
+
+
+// MapProperty::Change
+
+template<typename Key, typename Value, typename KeyHash>
+MapProperty<Key, Value, KeyHash>::Change::Change(
+		MapProperty* property, Key key, Value value, bool present)
+	: property_(property)
+	, key_(std::move(key))
+	, value_(std::move(value))
+	, present_(present)
+{}
+
+template<typename Key, typename Value, typename KeyHash>
+void MapProperty<Key, Value, KeyHash>::Change::Apply(bool reverse) {
+	ApplyPartitioned(reverse);
+	Notify();
+}
+
+template<typename Key, typename Value, typename KeyHash>
+const void* MapProperty<Key, Value, KeyHash>::Change::Partition() const {
+	return property_->owner_;
+}
+
+template<typename Key, typename Value, typename KeyHash>
+void MapProperty<Key, Value, KeyHash>::Change::ApplyPartitioned(bool reverse) {
+	auto& table = property_->table_;
+	auto* current = table.Find(key_);
+
+	if (current && present_) {
+		std::swap(*current, value_);
+	} else if (current) {
+		value_ = std::move(*current);
+		table.Erase(key_);
+		present_ = true;
+	} else if (present_) {
+		table.Insert(key_, std::move(value_));
+		value_ = Value();
+		present_ = false;
+	}
+}
+
+template<typename Key, typename Value, typename KeyHash>
+void MapProperty<Key, Value, KeyHash>::Change::Notify() {
+	property_->NotifyOwner();
+}
+
+
+// MapProperty::ReplaceAll
+
+template<typename Key, typename Value, typename KeyHash>
+MapProperty<Key, Value, KeyHash>::ReplaceAll::ReplaceAll(MapProperty* property)
+	: property_(property)
+{}
+
+template<typename Key, typename Value, typename KeyHash>
+void MapProperty<Key, Value, KeyHash>::ReplaceAll::Apply(bool reverse) {
+	property_->table_.Swap(table_);
+	property_->NotifyOwner();
+}
+
+} // namespace undoable
@@ -0,0 +1,82 @@
+#pragma once
+#include "undoable/Property.h"
+#include "undoable/Command.h"
+#include "undoable/HashTable.h"
+#include "undoable/Hash.h"
+
+
+namespace undoable {
+
+template<typename Key, typename Value, typename KeyHash=std::hash<Key>>
+class MapProperty
+	: public Property {
+public:
+	using Table = HashTable<Key, Value, KeyHash>;
+	using const_iterator = typename Table::const_iterator;
+
+	MapProperty(PropertyOwner* owner);
+	virtual void OnReset() override {}
+	virtual std::uint64_t Hash() const override;
+
+	std::size_t Size() const;
+	bool IsEmpty() const;
+	bool Contains(const Key& key) const;
+	const Value* Find(const Key& key) const;
+	const Value& At(const Key& key) const;
+
+	/**
+	 * Inserts the value if the key is not present yet.
+	 * Returns true if the value was inserted.
+	 */
+	bool Insert(Key key, Value value);
+
+	/**
+	 * Inserts or overwrites the value of the key.
+	 */
+	void Assign(Key key, Value value);
+
+	/**
+	 * Returns true if the key was present.
+	 */
+	bool Erase(const Key& key);
+	void Clear();
+
+	const_iterator begin() const;
+	const_iterator end() const;
+
+private:
+	/**
+	 * Swaps the entry of a single key with the stored one,
+	 * where either side can be missing.
+	 */
+	class Change : public Command {
+	public:
+		Change(MapProperty* property, Key key, Value value, bool present);
+		virtual void Apply(bool reverse) override;
+		virtual const void* Partition() const override;
+		virtual void ApplyPartitioned(bool reverse) override;
+		virtual void Notify() override;
+
+	private:
+		MapProperty* property_;
+		Key key_;
+		Value value_;
+		bool present_;
+	};
+
+	class ReplaceAll : public Command {
+	public:
+		ReplaceAll(MapProperty* property);
+		virtual void Apply(bool reverse) override;
+
+	private:
+		MapProperty* property_;
+		Table table_;
+	};
+
+	Table table_;
+};
+
+} // namespace undoable
+
+#include "undoable/MapProperty-inl.h"
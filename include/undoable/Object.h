@@ -1,5 +1,8 @@
 #pragma once
+#include <cstdint>
 #include <list>
+#include <unordered_set>
+#include <vector>
 #include "undoable/History.h"
 #include "undoable/Property.h"
 #include "undoable/ListProperty.h"
@@ -21,6 +24,7 @@ public:
 
 protected:
 	friend class Factory;
+	friend class Builder;
 	static void Link(ObjectBase* u, ObjectBase* v);
 
 	ObjectBase* next_object_;
@@ -53,8 +57,9 @@ public:
 
 private:
 	friend class Factory;
+	friend class Builder;
 
-	enum class Status {
+	enum class Status : std::uintptr_t {
 		kConstructing,
 		kOnCreate,
 		kCreated,
@@ -68,6 +73,8 @@ private:
 		StatusChange(Object* obj, bool create);
 		virtual ~StatusChange();
 		virtual void Apply(bool reverse) override;
+		virtual void Spill(SpillWriter& writer) override;
+		virtual void Reload(SpillReader& reader) override;
 
 	private:
 		Object* obj_;
@@ -75,13 +82,42 @@ private:
 		bool destructable_;
 	};
 
+	/**
+	 * Lifecycle change of many objects as a single command. Objects are
+	 * created in order, and destroyed in reverse order.
+	 */
+	class BatchStatusChange : public Command {
+	public:
+		BatchStatusChange(std::vector<Object*> objs, bool create);
+		virtual ~BatchStatusChange();
+		virtual void Apply(bool reverse) override;
+		virtual void Spill(SpillWriter& writer) override;
+		virtual void Reload(SpillReader& reader) override;
+
+	private:
+		std::vector<Object*> objs_;
+		bool create_;
+		bool destructable_;
+	};
+
 	void Init(History* history);
+	void ApplyStatus(bool create);
 	void DestroyMembers();
+	void DestroyMembers(
+		const std::unordered_set<const PropertyOwner*>& destroyed);
 	static void Destruct(Object* obj);
 	virtual void ApplyPropertyChange(UniquePtr<Command> command) override;
+	virtual void TrackPropertyChange(Property* property) override;
+
+	History* GetHistory() const;
+	void SetHistory(History* history);
+	Status GetStatus() const;
+	void SetStatus(Status status);
 
-	History* history_ = nullptr;
-	Status status_ = Status::kConstructing;
+	// Note: the status is stored in the low bits of the History pointer.
+	static constexpr std::uintptr_t kStatusMask = 7;
+	std::uintptr_t header_ =
+		static_cast<std::uintptr_t>(Status::kConstructing);
 };
 
 } // namespace undoable
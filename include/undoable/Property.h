@@ -1,4 +1,8 @@
 #pragma once
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
 #include "undoable/UniquePtr.h"
 #include "undoable/Command.h"
 
@@ -7,19 +11,55 @@ namespace undoable {
 class Property;
 class PropertyOwner;
 
+using Captures =
+	std::vector<std::pair<const Property*, std::shared_ptr<const void>>>;
+
 class Property {
 public:
 	Property(PropertyOwner* owner);
 	virtual ~Property() = default;
 	virtual void OnReset() = 0;
 
+	/**
+	 * Called when another property of the same owner has changed,
+	 * if the owner has computed properties.
+	 */
+	virtual void OnDependencyChange(Property* property) {}
+
+	/**
+	 * Hash of the content, used by DocumentHash.
+	 */
+	virtual std::uint64_t Hash() const { return 0; }
+
+	/**
+	 * Adds an immutable copy of the content, used by Snapshot.
+	 */
+	virtual void Capture(Captures& captures) const {}
+
+	/**
+	 * Moves the content out of memory while the owner is destroyed and
+	 * its destruction is spilled. Reload() reads back what Spill() wrote.
+	 */
+	virtual void Spill(SpillWriter& writer) {}
+	virtual void Reload(SpillReader& reader) {}
+
+	/**
+	 * Incremented whenever a change of the property is applied,
+	 * including undo and redo.
+	 */
+	std::uint32_t Version() const;
+
 protected:
 	void NotifyOwner();
 	PropertyOwner* owner_ = nullptr;
 
 private:
 	friend class PropertyOwner;
+	friend class Fragment;
+	friend class ComputedPropertyBase;
+	friend class DocumentHash;
 	Property* next_property_ = nullptr;
+	std::uint32_t version_ = 0;
 };
 
 
@@ -29,18 +69,56 @@ public:
 	virtual void OnPropertyChange(Property* property) = 0;
 	virtual void ApplyPropertyChange(UniquePtr<Command> command) = 0;
 
+	/**
+	 * Called before OnPropertyChange() when a change is applied.
+	 */
+	virtual void TrackPropertyChange(Property* property) {}
+
 	/**
 	 * Calls OnReset() on all properties.
 	 */
 	void ResetAllProperties();
 
+	/**
+	 * Calls OnDependencyChange() on all properties.
+	 */
+	void InvalidateComputed(Property* property);
+
+	/**
+	 * Combines the hashes of all properties in registration order.
+	 */
+	std::uint64_t HashAllProperties() const;
+
+	/**
+	 * Calls Capture() on all properties.
+	 */
+	void CaptureAllProperties(Captures& captures) const;
+
+	/**
+	 * Calls Spill() and Reload() on all properties.
+	 */
+	void SpillAllProperties(SpillWriter& writer);
+	void ReloadAllProperties(SpillReader& reader);
+
+	/**
+	 * Incremented whenever a change of any of the properties is applied.
+	 */
+	std::uint32_t Version() const;
+
 protected:
 	friend class Property;
+	friend class ComputedPropertyBase;
+	friend class Fragment;
+	friend class DocumentHash;
 	void RegisterProperty(Property* property);
+	virtual void IncrementVersion();
 
-	Property* first_property_ = nullptr;
+	// Note: properties form a circular list, the first one is
+	// `last_property_->next_property_`.
 	Property* last_property_ = nullptr;
 	bool on_change_ = false;
+	bool has_computed_ = false;
+	std::uint32_t properties_version_ = 0;
 };
 
 } // namespace undoable
@@ -1,10 +1,12 @@
 #pragma once
 #include "undoable/Property.h"
 #include <type_traits>
+#include <unordered_set>
 
 
 namespace undoable {
 
+class RefLink;
 class RefNode;
 class Referable;
 class RefPropertyBase;
@@ -12,7 +14,28 @@ class RefPropertyBase;
 template<typename Type> class RefProperty;
 
 
-class RefNode {
+class RefLink {
+public:
+	RefLink() = default;
+	~RefLink() {
+		LinkRef(prev_ref_, next_ref_);
+	}
+
+protected:
+	friend class RefNode;
+	friend class Referable;
+	friend class RefPropertyBase;
+
+	static void LinkRef(RefLink* u, RefLink* v);
+
+	RefLink* next_ref_{this};
+	RefLink* prev_ref_{this};
+};
+
+
+class RefNode
+	: public RefLink
+{
 public:
 	RefNode() = default;
 	~RefNode() {
@@ -24,10 +47,7 @@ protected:
 	friend class RefPropertyBase;
 
 	void UnlinkRef();
-	static void LinkRef(RefNode* u, RefNode* v);
 
-	RefNode* next_ref_{this};
-	RefNode* prev_ref_{this};
 	Referable* referable_{nullptr};
 };
 
@@ -41,8 +61,15 @@ protected:
 	void LinkBack(RefPropertyBase* ref);
 	void ResetAllReferences();
 
+	/**
+	 * Like ResetAllReferences(), but keeps references of the given owners.
+	 */
+	void ResetReferencesExcept(
+		const std::unordered_set<const PropertyOwner*>& owners);
+
 private:
-	RefNode head_;
+	// Note: the head does not need a `referable_`, so it is just a link.
+	RefLink head_;
 };
 
 
@@ -53,6 +80,8 @@ class RefPropertyBase
 public:
 	RefPropertyBase(PropertyOwner* owner);
 	virtual void OnReset() override;
+	virtual std::uint64_t Hash() const override;
+	virtual void Capture(Captures& captures) const override;
 
 protected:
 	friend class Referable;
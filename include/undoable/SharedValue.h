@@ -0,0 +1,91 @@
+#pragma once
+#include <memory>
+#include "undoable/ValueProperty.h"
+
+
+namespace undoable {
+
+/**
+ * Immutable, reference counted value. Copies share the payload, so
+ * storing it in a ValueProperty makes Set() and undo/redo a pointer swap.
+ * Equality is decided by identity first and by value only if that fails.
+ */
+template<typename T>
+class SharedValue {
+public:
+	SharedValue();
+	SharedValue(T value);
+
+	const T& Get() const;
+	const T& operator*() const;
+	const T* operator->() const;
+	bool IsSame(const SharedValue& other) const;
+
+	bool operator==(const SharedValue& other) const;
+	bool operator!=(const SharedValue& other) const;
+
+private:
+	static const std::shared_ptr<const T>& Default();
+
+	std::shared_ptr<const T> ptr_;
+};
+
+template<typename T>
+using SharedValueProperty = ValueProperty<SharedValue<T>>;
+
+template<typename T>
+auto HashValue(const SharedValue<T>& value)
+	-> typename std::enable_if<IsHashable<T>::value, std::uint64_t>::type
+{
+	return HashValue(value.Get());
+}
+
+
+template<typename T>
+SharedValue<T>::SharedValue()
+	: ptr_(Default())
+{}
+
+template<typename T>
+SharedValue<T>::SharedValue(T value)
+	: ptr_(std::make_shared<const T>(std::move(value)))
+{}
+
+template<typename T>
+const T& SharedValue<T>::Get() const {
+	return *ptr_;
+}
+
+template<typename T>
+const T& SharedValue<T>::operator*() const {
+	return *ptr_;
+}
+
+template<typename T>
+const T* SharedValue<T>::operator->() const {
+	return ptr_.get();
+}
+
+template<typename T>
+bool SharedValue<T>::IsSame(const SharedValue& other) const {
+	return ptr_ == other.ptr_;
+}
+
+template<typename T>
+bool SharedValue<T>::operator==(const SharedValue& other) const {
+	return IsSame(other) || *ptr_ == *other.ptr_;
+}
+
+template<typename T>
+bool SharedValue<T>::operator!=(const SharedValue& other) const {
+	return !(*this == other);
+}
+
+template<typename T>
+const std::shared_ptr<const T>& SharedValue<T>::Default() {
+	// Note: default constructed values share a single payload
+	static const std::shared_ptr<const T> value = std::make_shared<const T>();
+	return value;
+}
+
+} // namespace undoable
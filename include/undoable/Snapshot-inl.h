@@ -0,0 +1,29 @@
+#pragma once
+
+
+namespace undoable {
+
+template<typename T>
+const T* Snapshot::Get(
+	const Object& object, const ValueProperty<T>& property) const
+{
+	return static_cast<const T*>(Find(object, property));
+}
+
+template<typename T>
+const T* Snapshot::Get(
+	const Object& object, const RefProperty<T>& property) const
+{
+	auto* referable = static_cast<const Referable* const*>(
+		Find(object, property));
+	return referable ? static_cast<const T*>(*referable) : nullptr;
+}
+
+template<typename T, typename Tag>
+const std::vector<const T*>* Snapshot::Get(
+	const Object& object, const ListProperty<T, Tag>& property) const
+{
+	return static_cast<const std::vector<const T*>*>(Find(object, property));
+}
+
+} // namespace undoable
@@ -0,0 +1,103 @@
+#pragma once
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include "undoable/History.h"
+#include "undoable/Property.h"
+#include "undoable/ValueProperty.h"
+#include "undoable/RefProperty.h"
+#include "undoable/ListProperty.h"
+
+
+namespace undoable {
+
+class Factory;
+class Object;
+class Snapshot;
+class SnapshotManager;
+
+
+/**
+ * Immutable contents of the created objects at a revision. A snapshot
+ * can be read from any thread, live objects are only used as keys.
+ * Functions return nullptr if the object did not exist at the revision.
+ */
+class Snapshot {
+public:
+	bool Contains(const Object& object) const;
+	std::size_t Size() const;
+
+	template<typename T>
+	const T* Get(const Object& object,
+		const ValueProperty<T>& property) const;
+
+	template<typename T>
+	const T* Get(const Object& object,
+		const RefProperty<T>& property) const;
+
+	template<typename T, typename Tag>
+	const std::vector<const T*>* Get(const Object& object,
+		const ListProperty<T, Tag>& property) const;
+
+private:
+	friend class SnapshotManager;
+
+	using Bucket = std::unordered_map<const Object*, std::shared_ptr<const Captures>>;
+
+	static std::size_t BucketIndex(const Object* object, std::size_t count);
+
+	const void* Find(const Object& object, const Property& property) const;
+
+	// Note: buckets are shared between snapshots and the manager,
+	// only buckets with changed objects are copied.
+	std::vector<std::shared_ptr<const Bucket>> buckets_;
+	std::size_t size_ = 0;
+};
+
+
+/**
+ * Maintains the captures of a Factory from the change sets of its History.
+ * Pin() has to be called on the thread owning the Factory, the returned
+ * snapshot is freed when the last reader releases it.
+ *
+ * Captures are kept in buckets of about kBucketSize objects, which are
+ * copied on the first write after a Pin(), whether or not the snapshot is
+ * still held. Pinning costs one pointer per bucket, and a change set
+ * copies only the buckets it touches.
+ */
+class SnapshotManager
+	: public ChangeListener
+{
+public:
+	SnapshotManager(Factory& factory);
+	~SnapshotManager();
+	SnapshotManager(const SnapshotManager&) = delete;
+	SnapshotManager& operator=(const SnapshotManager&) = delete;
+
+	std::shared_ptr<const Snapshot> Pin();
+
+	virtual void OnChanges(const ChangeSet& changes) override;
+
+private:
+	using Bucket = Snapshot::Bucket;
+
+	static constexpr std::size_t kBucketSize = 64;
+	static constexpr std::size_t kMinBuckets = 16;
+
+	Bucket& Modify(const Object* object);
+	void Capture(const Object* object);
+	void Erase(const Object* object);
+	void Grow();
+
+	History& history_;
+	std::vector<std::shared_ptr<Bucket>> buckets_;
+	// Note: reference counts of published buckets cannot tell if a reader
+	// on another thread is done with them, so they are never written.
+	std::vector<bool> published_;
+	std::size_t size_ = 0;
+	std::shared_ptr<const Snapshot> current_;
+};
+
+} // namespace undoable
+
+#include "undoable/Snapshot-inl.h"
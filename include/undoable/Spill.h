@@ -0,0 +1,151 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+namespace undoable {
+
+/**
+ * Contiguous containers of trivially copyable values.
+ */
+template<typename Container>
+using IsSpillable = std::integral_constant<bool,
+	std::is_trivially_copyable<typename Container::value_type>::value &&
+	!std::is_same<Container, std::vector<bool>>::value>;
+
+
+/**
+ * Any value with a spillable layout: contiguous containers with data() of
+ * trivially copyable values, like std::string or std::vector<int>.
+ */
+template<typename T, typename = void>
+struct IsSpillableValue : std::false_type {};
+
+template<typename T>
+struct IsSpillableValue<T, decltype(
+	std::declval<T&>().data(), std::declval<typename T::value_type*>(), void())>
+	: IsSpillable<T> {};
+
+
+/**
+ * Collects the payloads of the commands of a Transaction.
+ * Values which are not spillable are kept in memory.
+ */
+class SpillWriter {
+public:
+	/**
+	 * Appends the values and releases the memory of the container.
+	 */
+	template<typename Container> void Write(Container& values);
+
+	std::vector<char> Take();
+
+private:
+	template<typename Container>
+	void WriteValues(Container& values, std::true_type);
+	template<typename Container>
+	void WriteValues(Container& values, std::false_type) {}
+
+	std::vector<char> bytes_;
+};
+
+
+class SpillReader {
+public:
+	explicit SpillReader(std::vector<char> bytes);
+
+	/**
+	 * Restores values written by SpillWriter::Write() in the same order.
+	 */
+	template<typename Container> void Read(Container& values);
+
+private:
+	template<typename Container>
+	void ReadValues(Container& values, std::true_type);
+	template<typename Container>
+	void ReadValues(Container& values, std::false_type) {}
+
+	std::vector<char> bytes_;
+	std::size_t offset_ = 0;
+};
+
+
+/**
+ * Keeps spilled transactions outside of the command objects.
+ */
+class SpillStore {
+public:
+	virtual ~SpillStore() = default;
+
+	static const std::uint64_t kNotStored = ~std::uint64_t(0);
+
+	/**
+	 * Stores the bytes and returns an id for Take() and Drop(), or
+	 * kNotStored if they could not be stored. The transaction then keeps
+	 * its payloads in memory.
+	 */
+	virtual std::uint64_t Put(const std::vector<char>& bytes) = 0;
+
+	/**
+	 * Returns the stored bytes and drops them. Stores which can fail to
+	 * read throw std::runtime_error, and keep the bytes stored.
+	 */
+	virtual std::vector<char> Take(std::uint64_t id) = 0;
+	virtual void Drop(std::uint64_t id) = 0;
+};
+
+
+// SpillWriter
+
+template<typename Container>
+void SpillWriter::Write(Container& values) {
+	WriteValues(values, IsSpillableValue<Container>());
+}
+
+template<typename Container>
+void SpillWriter::WriteValues(Container& values, std::true_type) {
+	std::uint64_t size = values.size();
+	auto bytes = values.size() * sizeof(typename Container::value_type);
+	auto offset = bytes_.size();
+	bytes_.resize(offset + sizeof(size) + bytes);
+	std::memcpy(&bytes_[offset], &size, sizeof(size));
+	if (bytes) {
+		std::memcpy(&bytes_[offset + sizeof(size)], &values[0], bytes);
+	}
+	Container().swap(values);
+}
+
+inline std::vector<char> SpillWriter::Take() {
+	return std::move(bytes_);
+}
+
+
+// SpillReader
+
+inline SpillReader::SpillReader(std::vector<char> bytes)
+	: bytes_(std::move(bytes))
+{}
+
+template<typename Container>
+void SpillReader::Read(Container& values) {
+	ReadValues(values, IsSpillableValue<Container>());
+}
+
+template<typename Container>
+void SpillReader::ReadValues(Container& values, std::true_type) {
+	std::uint64_t size;
+	std::memcpy(&size, &bytes_[offset_], sizeof(size));
+	offset_ += sizeof(size);
+
+	auto bytes = size * sizeof(typename Container::value_type);
+	values.resize(size);
+	if (bytes) {
+		std::memcpy(&values[0], &bytes_[offset_], bytes);
+	}
+	offset_ += bytes;
+}
+
+} // namespace undoable
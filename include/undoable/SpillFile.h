@@ -0,0 +1,69 @@
+#pragma once
+#include <cstdio>
+#include <map>
+#include <string>
+#include "undoable/Spill.h"
+
+
+namespace undoable {
+
+/**
+ * Stores spilled transactions in a local file. Space of taken or dropped
+ * transactions is reused by later ones, first fit, and free space at the
+ * end of the file is given back, so the used part of the file is bounded
+ * by the peak of the stored bytes plus fragmentation. The file itself is
+ * never truncated.
+ *
+ * If the file cannot be opened or written, e.g. on a full disk, Put()
+ * returns kNotStored and the transactions stay in memory. A failed read
+ * throws std::runtime_error from Undo(), which leaves the history as it
+ * was.
+ */
+class SpillFile
+	: public SpillStore {
+public:
+	/**
+	 * Uses an anonymous temporary file if the path is empty.
+	 */
+	explicit SpillFile(const std::string& path={});
+	~SpillFile();
+	SpillFile(const SpillFile&) = delete;
+	SpillFile& operator=(const SpillFile&) = delete;
+
+	bool IsOpen() const;
+
+	/**
+	 * Number of bytes held by stored transactions.
+	 */
+	std::uint64_t Size() const;
+
+	/**
+	 * Number of bytes used in the file, including free space between
+	 * stored transactions.
+	 */
+	std::uint64_t Extent() const;
+
+	virtual std::uint64_t Put(const std::vector<char>& bytes) override;
+	virtual std::vector<char> Take(std::uint64_t id) override;
+	virtual void Drop(std::uint64_t id) override;
+
+private:
+	struct Range {
+		std::uint64_t offset;
+		std::uint64_t size;
+	};
+
+	std::uint64_t Allocate(std::uint64_t size);
+	void Free(Range range);
+
+	std::FILE* file_ = nullptr;
+	std::vector<Range> extents_;
+	std::vector<std::uint64_t> free_ids_;
+	// Note: free ranges by offset, adjacent ranges are joined.
+	std::map<std::uint64_t, std::uint64_t> free_;
+	std::uint64_t end_ = 0;
+	std::uint64_t size_ = 0;
+	std::size_t live_ = 0;
+};
+
+} // namespace undoable
@@ -0,0 +1,114 @@
+#pragma once
+#include <utility>
+
+
+namespace undoable {
+
+template<typename T>
+StructProperty<T>::StructProperty(PropertyOwner* owner, T value)
+	: Property(owner)
+	, value_(std::move(value))
+{}
+
+template<typename T>
+std::uint64_t StructProperty<T>::Hash() const {
+	return TryHashValue(value_);
+}
+
+template<typename T>
+const T& StructProperty<T>::Get() const {
+	return value_;
+}
+
+template<typename T>
+const T* StructProperty<T>::operator->() const {
+	return &value_;
+}
+
+template<typename T>
+template<typename M>
+const M& StructProperty<T>::Get(M T::*field) const {
+	return value_.*field;
+}
+
+template<typename T>
+template<typename M>
+void StructProperty<T>::Set(
+	M T::*field, typename std::common_type<M>::type value)
+{
+	if (value != value_.*field) {
+		auto cmd = MakeUnique<FieldChange<M>>(this, field, std::move(value));
+		owner_->ApplyPropertyChange(std::move(cmd));
+	}
+}
+
+template<typename T>
+template<typename M>
+void StructProperty<T>::Reset(M T::*field) {
+	Set(field, M());
+}
+
+template<typename T>
+void StructProperty<T>::Assign(T value) {
+	auto cmd = MakeUnique<Change>(this, std::move(value));
+	owner_->ApplyPropertyChange(std::move(cmd));
+}
+
+template<typename T>
+void StructProperty<T>::Reset() {
+	Assign(T());
+}
+
+
+// StructProperty<T>::Change
+
+template<typename T>
+StructProperty<T>::Change::Change(StructProperty* property, T value)
+	: property_(property)
+	, value_(std::move(value))
+{}
+
+template<typename T>
+void StructProperty<T>::Change::Apply(bool reverse) {
+	std::swap(property_->value_, value_);
+	property_->NotifyOwner();
+}
+
+
+// StructProperty<T>::FieldChange<M>
+
+template<typename T>
+template<typename M>
+StructProperty<T>::FieldChange<M>::FieldChange(
+		StructProperty* property, M T::*field, M value)
+	: property_(property)
+	, field_(field)
+	, value_(std::move(value))
+{}
+
+template<typename T>
+template<typename M>
+void StructProperty<T>::FieldChange<M>::Apply(bool reverse) {
+	ApplyPartitioned(reverse);
+	Notify();
+}
+
+template<typename T>
+template<typename M>
+const void* StructProperty<T>::FieldChange<M>::Partition() const {
+	return property_->owner_;
+}
+
+template<typename T>
+template<typename M>
+void StructProperty<T>::FieldChange<M>::ApplyPartitioned(bool reverse) {
+	std::swap(property_->value_.*field_, value_);
+}
+
+template<typename T>
+template<typename M>
+void StructProperty<T>::FieldChange<M>::Notify() {
+	property_->NotifyOwner();
+}
+
+} // namespace undoable
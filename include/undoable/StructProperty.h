@@ -0,0 +1,74 @@
+#pragma once
+#include <type_traits>
+#include "undoable/Property.h"
+#include "undoable/Command.h"
+#include "undoable/Hash.h"
+
+
+namespace undoable {
+
+/**
+ * Stores a plain struct of fields behind a single property header.
+ * Fields are addressed by member pointers, and each change only records
+ * the affected field, e.g. `data.Set(&ShapeData::x, 5)`.
+ */
+template<typename T>
+class StructProperty
+	: public Property {
+public:
+	StructProperty(PropertyOwner* owner, T value=T());
+	virtual void OnReset() override {}
+	virtual std::uint64_t Hash() const override;
+
+	const T& Get() const;
+	const T* operator->() const;
+
+	template<typename M> const M& Get(M T::*field) const;
+
+	/**
+	 * Only the field type is deduced from the member pointer, so values
+	 * convertible to it can be passed, e.g. `Set(&ShapeData::name, "box")`.
+	 */
+	template<typename M>
+	void Set(M T::*field, typename std::common_type<M>::type value);
+	template<typename M> void Reset(M T::*field);
+
+	/**
+	 * Replaces all fields as a single change, which is recorded even if
+	 * the value is the same, since T is not required to be comparable.
+	 */
+	void Assign(T value);
+	void Reset();
+
+private:
+	class Change : public Command {
+	public:
+		Change(StructProperty* property, T value);
+		virtual void Apply(bool reverse) override;
+
+	private:
+		StructProperty* property_;
+		T value_;
+	};
+
+	template<typename M>
+	class FieldChange : public Command {
+	public:
+		FieldChange(StructProperty* property, M T::*field, M value);
+		virtual void Apply(bool reverse) override;
+		virtual const void* Partition() const override;
+		virtual void ApplyPartitioned(bool reverse) override;
+		virtual void Notify() override;
+
+	private:
+		StructProperty* property_;
+		M T::*field_;
+		M value_;
+	};
+
+	T value_;
+};
+
+} // namespace undoable
+
+#include "undoable/StructProperty-inl.h"
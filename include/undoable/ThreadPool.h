@@ -0,0 +1,53 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+namespace undoable {
+
+/**
+ * Fixed set of worker threads used by History for parallel undo and redo.
+ */
+class ThreadPool {
+public:
+	explicit ThreadPool(
+		std::size_t threads=std::thread::hardware_concurrency());
+	~ThreadPool();
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	std::size_t Size() const;
+
+	/**
+	 * Calls `task(i)` for every i in [0, count) on the workers and on the
+	 * calling thread, and returns when all calls are done. Indices are
+	 * claimed one by one, so threads finishing early take over the rest.
+	 */
+	void Run(std::size_t count, const std::function<void(std::size_t)>& task);
+
+private:
+	void Work();
+	void Process(const std::function<void(std::size_t)>& task,
+		std::size_t count);
+
+	std::vector<std::thread> threads_;
+	std::mutex mutex_;
+	std::condition_variable wake_;
+	std::condition_variable done_;
+
+	const std::function<void(std::size_t)>* task_ = nullptr;
+	std::size_t count_ = 0;
+	std::uint64_t generation_ = 0;
+	std::size_t active_ = 0;
+	bool stop_ = false;
+
+	std::atomic<std::size_t> next_{0};
+	std::atomic<std::size_t> remaining_{0};
+};
+
+} // namespace undoable
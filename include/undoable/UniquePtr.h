@@ -1,5 +1,6 @@
 #pragma once
 #include <memory>
+#include <utility>
 
 namespace undoable {
 
@@ -7,7 +8,7 @@ template<typename T> using UniquePtr = std::unique_ptr<T>;
 
 template<typename T, typename... Args>
 UniquePtr<T> MakeUnique(Args&&... args) {
-	return std::make_unique<T>(args...);
+	return std::make_unique<T>(std::forward<Args>(args)...);
 }
 
 } // namespace undoable
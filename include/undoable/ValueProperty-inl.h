@@ -14,14 +14,35 @@ const T& ValueProperty<T>::Get() const {
 	return value_;
 }
 
+template<typename T>
+std::uint64_t ValueProperty<T>::Hash() const {
+	return TryHashValue(value_);
+}
+
+template<typename T>
+void ValueProperty<T>::Capture(Captures& captures) const {
+	captures.emplace_back(this, std::make_shared<const T>(value_));
+}
+
 template<typename T>
 void ValueProperty<T>::Set(T value) {
 	if (value != value_) {
-		auto cmd = MakeUnique<Change>(this, std::move(value));
+		auto cmd = MakeChange(std::move(value),
+			std::is_trivially_copyable<T>());
 		owner_->ApplyPropertyChange(std::move(cmd));
 	}
 }
 
+template<typename T>
+UniquePtr<Command> ValueProperty<T>::MakeChange(T value, std::false_type) {
+	return MakeUnique<Change>(this, std::move(value));
+}
+
+template<typename T>
+UniquePtr<Command> ValueProperty<T>::MakeChange(T value, std::true_type) {
+	return MakeUnique<Batch>(this, std::move(value));
+}
+
 template<typename T>
 ValueProperty<T>::Change::Change(ValueProperty* property, T value)
 	: property_(property)
@@ -30,8 +51,160 @@ ValueProperty<T>::Change::Change(ValueProperty* property, T value)
 
 template<typename T>
 void ValueProperty<T>::Change::Apply(bool reverse) {
+	ApplyPartitioned(reverse);
+	Notify();
+}
+
+template<typename T>
+const void* ValueProperty<T>::Change::Partition() const {
+	return property_->owner_;
+}
+
+template<typename T>
+void ValueProperty<T>::Change::ApplyPartitioned(bool reverse) {
 	std::swap(property_->value_, value_);
+}
+
+template<typename T>
+void ValueProperty<T>::Change::Notify() {
 	property_->NotifyOwner();
 }
 
+template<typename T>
+bool ValueProperty<T>::Change::Merge(Command& command) {
+	// Note: the earlier change keeps the original value,
+	// the property already has the value of the later one.
+	return command.Tag() == &kTag &&
+		static_cast<Change&>(command).property_ == property_;
+}
+
+template<typename T>
+const void* ValueProperty<T>::Change::Tag() const {
+	return &kTag;
+}
+
+template<typename T>
+void ValueProperty<T>::Change::Spill(SpillWriter& writer) {
+	writer.Write(value_);
+}
+
+template<typename T>
+void ValueProperty<T>::Change::Reload(SpillReader& reader) {
+	reader.Read(value_);
+}
+
+template<typename T>
+const char ValueProperty<T>::Change::kTag = 0;
+
+
+// ValueProperty<T>::Batch
+
+template<typename T>
+const char ValueProperty<T>::Batch::kTag = 0;
+
+template<typename T>
+ValueProperty<T>::Batch::Batch(ValueProperty* property, T value)
+	: first_{property, value}
+{}
+
+template<typename T>
+template<typename Fn>
+void ValueProperty<T>::Batch::ForEachEntry(bool reverse, Fn fn) {
+	if (!reverse) {
+		fn(first_);
+		for (auto& entry : rest_) {
+			fn(entry);
+		}
+	} else {
+		for (auto it = rest_.rbegin(); it != rest_.rend(); ++it) {
+			fn(*it);
+		}
+		fn(first_);
+	}
+}
+
+template<typename T>
+void ValueProperty<T>::Batch::Apply(bool reverse) {
+	ForEachEntry(reverse, [](Entry& entry) {
+		std::swap(entry.property->value_, entry.value);
+	});
+	ForEachEntry(reverse, [](Entry& entry) {
+		entry.property->NotifyOwner();
+	});
+}
+
+template<typename T>
+void ValueProperty<T>::Batch::ApplyParallel(bool reverse, ThreadPool& pool) {
+	if (rest_.size() + 1 < kMinParallelSize) {
+		Apply(reverse);
+		return;
+	}
+
+	// Entries of an owner keep their relative order
+	std::unordered_map<const PropertyOwner*, std::size_t> index;
+	std::vector<std::vector<Entry*>> partitions;
+	ForEachEntry(reverse, [&](Entry& entry) {
+		auto result = index.emplace(entry.property->owner_, partitions.size());
+		if (result.second) {
+			partitions.emplace_back();
+		}
+		partitions[result.first->second].push_back(&entry);
+	});
+
+	pool.Run(partitions.size(), [&](std::size_t p) {
+		for (auto* entry : partitions[p]) {
+			std::swap(entry->property->value_, entry->value);
+		}
+	});
+
+	ForEachEntry(reverse, [](Entry& entry) {
+		entry.property->NotifyOwner();
+	});
+}
+
+template<typename T>
+bool ValueProperty<T>::Batch::Merge(Command& command) {
+	// Note: transactions only merge commands which were applied forward,
+	// so the entries stay in the order they were applied.
+	if (command.Tag() != &kTag) {
+		return false;
+	}
+
+	auto& batch = static_cast<Batch&>(command);
+	if (rest_.capacity() == 0) {
+		rest_.reserve(kInitialCapacity);
+	}
+	rest_.push_back(batch.first_);
+	rest_.insert(rest_.end(), batch.rest_.begin(), batch.rest_.end());
+	return true;
+}
+
+template<typename T>
+const void* ValueProperty<T>::Batch::Tag() const {
+	return &kTag;
+}
+
+template<typename T>
+void ValueProperty<T>::Batch::Compact() {
+	// Note: the batch is applied, so the earliest entry of a property
+	// holds its value before the batch, later entries are redundant.
+	std::unordered_set<const ValueProperty*> seen{first_.property};
+	auto last = std::remove_if(rest_.begin(), rest_.end(),
+		[&](const Entry& entry) {
+			return !seen.insert(entry.property).second;
+		});
+	rest_.erase(last, rest_.end());
+	rest_.shrink_to_fit();
+}
+
+template<typename T>
+void ValueProperty<T>::Batch::Spill(SpillWriter& writer) {
+	writer.Write(rest_);
+}
+
+template<typename T>
+void ValueProperty<T>::Batch::Reload(SpillReader& reader) {
+	reader.Read(rest_);
+}
+
 } // namespace undoable
@@ -1,6 +1,14 @@
 #pragma once
+#include <algorithm>
+#include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 #include "undoable/Property.h"
 #include "undoable/Command.h"
+#include "undoable/Hash.h"
+#include "undoable/Spill.h"
+#include "undoable/ThreadPool.h"
 
 
 namespace undoable {
@@ -11,6 +19,8 @@ class ValueProperty
 public:
 	ValueProperty(PropertyOwner* owner, T value=T());
 	virtual void OnReset() override {}
+	virtual std::uint64_t Hash() const override;
+	virtual void Capture(Captures& captures) const override;
 
 	const T& Get() const;
 	void Set(T value);
@@ -20,12 +30,65 @@ private:
 	public:
 		Change(ValueProperty* property, T value);
 		virtual void Apply(bool reverse) override;
+		virtual const void* Partition() const override;
+		virtual void ApplyPartitioned(bool reverse) override;
+		virtual void Notify() override;
+		virtual bool Merge(Command& command) override;
+		virtual const void* Tag() const override;
+		virtual void Spill(SpillWriter& writer) override;
+		virtual void Reload(SpillReader& reader) override;
 
 	private:
+		static const char kTag;
+
 		ValueProperty* property_;
 		T value_;
 	};
 
+	/**
+	 * Used for trivially copyable values. Adjacent changes in a Transaction
+	 * are merged, so they are restored in a single loop. All values are
+	 * swapped first, then the owners are notified in the order of the
+	 * restore, so owners see the whole batch restored, like with
+	 * partitioned commands. Large batches are split by owner in a
+	 * parallel undo or redo.
+	 *
+	 * The first entry is stored inline, so a single change costs one
+	 * allocation like Change does. The other entries are spilled with
+	 * their Transaction. Squashing keeps one entry per property.
+	 */
+	class Batch : public Command {
+	public:
+		Batch(ValueProperty* property, T value);
+		virtual void Apply(bool reverse) override;
+		virtual void ApplyParallel(bool reverse, ThreadPool& pool) override;
+		virtual bool Merge(Command& command) override;
+		virtual const void* Tag() const override;
+		virtual void Compact() override;
+		virtual void Spill(SpillWriter& writer) override;
+		virtual void Reload(SpillReader& reader) override;
+
+	private:
+		static const std::size_t kMinParallelSize = 256;
+		static const std::size_t kInitialCapacity = 16;
+		static const char kTag;
+
+		// Note: entries keep the property and the value side by side,
+		// which also keeps std::vector<bool> packing out of the way.
+		struct Entry {
+			ValueProperty* property;
+			T value;
+		};
+
+		template<typename Fn> void ForEachEntry(bool reverse, Fn fn);
+
+		Entry first_;
+		std::vector<Entry> rest_;
+	};
+
+	UniquePtr<Command> MakeChange(T value, std::false_type);
+	UniquePtr<Command> MakeChange(T value, std::true_type);
+
 	T value_;
 };
 
@@ -0,0 +1,190 @@
+#pragma once
+#include <algorithm>
+#include <cassert>
+#include <iterator>
+
+
+namespace undoable {
+
+template<typename T>
+VectorProperty<T>::VectorProperty(PropertyOwner* owner, std::vector<T> values)
+	: Property(owner)
+	, values_(std::move(values))
+{}
+
+template<typename T>
+void VectorProperty<T>::Spill(SpillWriter& writer) {
+	writer.Write(values_);
+}
+
+template<typename T>
+void VectorProperty<T>::Reload(SpillReader& reader) {
+	reader.Read(values_);
+}
+
+template<typename T>
+std::uint64_t VectorProperty<T>::Hash() const {
+	return TryHashValue(values_);
+}
+
+template<typename T>
+const std::vector<T>& VectorProperty<T>::Get() const {
+	return values_;
+}
+
+template<typename T>
+const T& VectorProperty<T>::At(std::size_t index) const {
+	assert(index < values_.size() && "Index out of range");
+	return values_[index];
+}
+
+template<typename T>
+const T& VectorProperty<T>::operator[](std::size_t index) const {
+	return At(index);
+}
+
+template<typename T>
+std::size_t VectorProperty<T>::Size() const {
+	return values_.size();
+}
+
+template<typename T>
+bool VectorProperty<T>::IsEmpty() const {
+	return values_.empty();
+}
+
+template<typename T>
+void VectorProperty<T>::SetAt(std::size_t index, T value) {
+	assert(index < values_.size() && "Index out of range");
+	if (value != values_[index]) {
+		std::vector<T> values;
+		values.push_back(std::move(value));
+		ApplySplice(index, 1, std::move(values));
+	}
+}
+
+template<typename T>
+void VectorProperty<T>::PushBack(T value) {
+	Insert(values_.size(), std::move(value));
+}
+
+template<typename T>
+void VectorProperty<T>::PopBack() {
+	assert(!values_.empty() && "Vector is empty");
+	Erase(values_.size() - 1, 1);
+}
+
+template<typename T>
+void VectorProperty<T>::Insert(std::size_t index, T value) {
+	assert(index <= values_.size() && "Index out of range");
+	std::vector<T> values;
+	values.push_back(std::move(value));
+	ApplySplice(index, 0, std::move(values));
+}
+
+template<typename T>
+void VectorProperty<T>::Erase(std::size_t index) {
+	Erase(index, 1);
+}
+
+template<typename T>
+template<typename It>
+void VectorProperty<T>::Insert(std::size_t index, It first, It last) {
+	assert(index <= values_.size() && "Index out of range");
+	if (first != last) {
+		ApplySplice(index, 0, std::vector<T>(first, last));
+	}
+}
+
+template<typename T>
+template<typename It>
+void VectorProperty<T>::Replace(std::size_t index, It first, It last) {
+	std::vector<T> values(first, last);
+	assert(index + values.size() <= values_.size() && "Index out of range");
+	if (!std::equal(values.begin(), values.end(), values_.begin() + index)) {
+		auto count = values.size();
+		ApplySplice(index, count, std::move(values));
+	}
+}
+
+template<typename T>
+void VectorProperty<T>::Erase(std::size_t index, std::size_t count) {
+	assert(index + count <= values_.size() && "Index out of range");
+	if (count > 0) {
+		ApplySplice(index, count, {});
+	}
+}
+
+template<typename T>
+void VectorProperty<T>::Clear() {
+	Erase(0, values_.size());
+}
+
+template<typename T>
+void VectorProperty<T>::ApplySplice(
+	std::size_t index, std::size_t count, std::vector<T> values)
+{
+	auto cmd = MakeUnique<Splice>(this, index, count, std::move(values));
+	owner_->ApplyPropertyChange(std::move(cmd));
+}
+
+
+// VectorProperty<T>::Splice
+
+template<typename T>
+VectorProperty<T>::Splice::Splice(VectorProperty* property, std::size_t index,
+		std::size_t count, std::vector<T> values)
+	: property_(property)
+	, index_(index)
+	, count_(count)
+	, values_(std::move(values))
+{}
+
+template<typename T>
+void VectorProperty<T>::Splice::Apply(bool reverse) {
+	ApplyPartitioned(reverse);
+	Notify();
+}
+
+template<typename T>
+const void* VectorProperty<T>::Splice::Partition() const {
+	return property_->owner_;
+}
+
+template<typename T>
+void VectorProperty<T>::Splice::ApplyPartitioned(bool reverse) {
+	auto& vec = property_->values_;
+	auto first = vec.begin() + index_;
+
+	if (count_ == values_.size()) {
+		// Note: same sized ranges are swapped in place
+		std::swap_ranges(values_.begin(), values_.end(), first);
+	} else {
+		auto last = first + count_;
+		std::vector<T> removed(
+			std::make_move_iterator(first), std::make_move_iterator(last));
+		first = vec.erase(first, last);
+		vec.insert(first,
+			std::make_move_iterator(values_.begin()),
+			std::make_move_iterator(values_.end()));
+		count_ = values_.size();
+		values_ = std::move(removed);
+	}
+}
+
+template<typename T>
+void VectorProperty<T>::Splice::Notify() {
+	property_->NotifyOwner();
+}
+
+template<typename T>
+void VectorProperty<T>::Splice::Spill(SpillWriter& writer) {
+	writer.Write(values_);
+}
+
+template<typename T>
+void VectorProperty<T>::Splice::Reload(SpillReader& reader) {
+	reader.Read(values_);
+}
+
+} // namespace undoable
@@ -0,0 +1,74 @@
+#pragma once
+#include <vector>
+#include "undoable/Property.h"
+#include "undoable/Command.h"
+#include "undoable/Hash.h"
+#include "undoable/Spill.h"
+
+
+namespace undoable {
+
+template<typename T>
+class VectorProperty
+	: public Property {
+public:
+	VectorProperty(PropertyOwner* owner, std::vector<T> values={});
+	virtual void OnReset() override {}
+	virtual std::uint64_t Hash() const override;
+	virtual void Spill(SpillWriter& writer) override;
+	virtual void Reload(SpillReader& reader) override;
+
+	const std::vector<T>& Get() const;
+	const T& At(std::size_t index) const;
+	const T& operator[](std::size_t index) const;
+	std::size_t Size() const;
+	bool IsEmpty() const;
+
+	/**
+	 * Element-level changes, only the affected elements are recorded.
+	 */
+	void SetAt(std::size_t index, T value);
+	void PushBack(T value);
+	void PopBack();
+	void Insert(std::size_t index, T value);
+	void Erase(std::size_t index);
+
+	/**
+	 * Range changes, `count` is the number of elements starting at `index`.
+	 */
+	template<typename It> void Insert(std::size_t index, It first, It last);
+	template<typename It> void Replace(std::size_t index, It first, It last);
+	void Erase(std::size_t index, std::size_t count);
+	void Clear();
+
+private:
+	/**
+	 * Replaces `count_` elements at `index_` with `values_`.
+	 * The replaced elements are kept for the reverse direction.
+	 */
+	class Splice : public Command {
+	public:
+		Splice(VectorProperty* property, std::size_t index,
+			std::size_t count, std::vector<T> values);
+		virtual void Apply(bool reverse) override;
+		virtual const void* Partition() const override;
+		virtual void ApplyPartitioned(bool reverse) override;
+		virtual void Notify() override;
+		virtual void Spill(SpillWriter& writer) override;
+		virtual void Reload(SpillReader& reader) override;
+
+	private:
+		VectorProperty* property_;
+		std::size_t index_;
+		std::size_t count_;
+		std::vector<T> values_;
+	};
+
+	void ApplySplice(std::size_t index, std::size_t count, std::vector<T> values);
+
+	std::vector<T> values_;
+};
+
+} // namespace undoable
+
+#include "undoable/VectorProperty-inl.h"
@@ -0,0 +1,20 @@
+#include "undoable/Builder.h"
+
+
+namespace undoable {
+
+Builder::~Builder() {
+	for (auto* obj : objects_) {
+		Object::Destruct(obj);
+	}
+}
+
+bool Builder::IsEmpty() const {
+	return objects_.empty();
+}
+
+std::size_t Builder::Size() const {
+	return objects_.size();
+}
+
+} // namespace undoable
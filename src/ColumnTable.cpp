@@ -0,0 +1,38 @@
+#include "undoable/ColumnTable.h"
+
+
+namespace undoable {
+
+
+// ColumnBase
+
+ColumnBase::ColumnBase(ColumnTable* table)
+	: Property(table)
+{
+	table->RegisterColumn(this);
+}
+
+
+// ColumnTable
+
+std::size_t ColumnTable::Size() const {
+	return columns_.empty() ? 0 : columns_.front()->Size();
+}
+
+void ColumnTable::Resize(std::size_t rows) {
+	for (auto* column : columns_) {
+		column->Resize(rows);
+	}
+}
+
+std::size_t ColumnTable::AddRows(std::size_t count) {
+	auto first = Size();
+	Resize(first + count);
+	return first;
+}
+
+void ColumnTable::RegisterColumn(ColumnBase* column) {
+	columns_.push_back(column);
+}
+
+} // namespace undoable
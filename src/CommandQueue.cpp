@@ -0,0 +1,94 @@
+#include "undoable/CommandQueue.h"
+
+
+namespace undoable {
+
+
+// CommandQueue::Batch
+
+void CommandQueue::Batch::Add(std::function<void()> edit) {
+	edits_.push_back({std::move(edit), nullptr});
+}
+
+void CommandQueue::Batch::Add(UniquePtr<Command> command) {
+	edits_.push_back({nullptr, std::move(command)});
+}
+
+bool CommandQueue::Batch::IsEmpty() const {
+	return edits_.empty();
+}
+
+
+// CommandQueue
+
+CommandQueue::~CommandQueue() {
+	TakeSubmitted();
+	while (auto* node = first_pending_) {
+		first_pending_ = node->next;
+		delete node;
+	}
+}
+
+void CommandQueue::Submit(Batch batch) {
+	auto* node = new Node{std::move(batch), nullptr};
+	node->next = submitted_.load(std::memory_order_relaxed);
+	while (!submitted_.compare_exchange_weak(node->next, node,
+		std::memory_order_release, std::memory_order_relaxed))
+	{}
+}
+
+std::size_t CommandQueue::Drain(History& history, std::size_t max_batches) {
+	if (history.CanCommit()) {
+		return 0;
+	}
+
+	TakeSubmitted();
+
+	std::size_t count = 0;
+	while (first_pending_ && count < max_batches) {
+		auto* node = first_pending_;
+		first_pending_ = node->next;
+		if (!first_pending_) {
+			last_pending_ = nullptr;
+		}
+
+		for (auto& edit : node->batch.edits_) {
+			if (edit.function) {
+				edit.function();
+			} else {
+				history.Stage(std::move(edit.command));
+			}
+		}
+		history.Commit();
+
+		delete node;
+		++count;
+	}
+	return count;
+}
+
+void CommandQueue::TakeSubmitted() {
+	auto* node = submitted_.exchange(nullptr, std::memory_order_acquire);
+	if (!node) {
+		return;
+	}
+
+	// Reverse the stack into submission order
+	Node* first = nullptr;
+	auto* last = node;
+	while (node) {
+		auto* next = node->next;
+		node->next = first;
+		first = node;
+		node = next;
+	}
+
+	if (last_pending_) {
+		last_pending_->next = first;
+	} else {
+		first_pending_ = first;
+	}
+	last_pending_ = last;
+}
+
+} // namespace undoable
@@ -0,0 +1,178 @@
+#include "undoable/CompressedStore.h"
+#include <cstring>
+#include <stdexcept>
+
+
+namespace undoable {
+
+namespace {
+
+const std::size_t kMinMatch = 4;
+const int kHashBits = 14;
+
+void WriteVarint(std::vector<char>& out, std::size_t value) {
+	while (value >= 0x80) {
+		out.push_back(static_cast<char>(value | 0x80));
+		value >>= 7;
+	}
+	out.push_back(static_cast<char>(value));
+}
+
+void Corrupted() {
+	throw std::runtime_error("Corrupted compressed buffer");
+}
+
+std::size_t ReadVarint(const std::vector<char>& in, std::size_t& pos) {
+	std::size_t value = 0;
+	int shift = 0;
+	while (true) {
+		if (pos >= in.size() ||
+			shift >= static_cast<int>(sizeof(std::size_t) * 8))
+		{
+			Corrupted();
+		}
+		auto byte = static_cast<unsigned char>(in[pos++]);
+		value |= static_cast<std::size_t>(byte & 0x7f) << shift;
+		if (!(byte & 0x80)) {
+			return value;
+		}
+		shift += 7;
+	}
+}
+
+std::uint32_t HashSequence(const char* p) {
+	std::uint32_t seq;
+	std::memcpy(&seq, p, sizeof(seq));
+	return (seq * 2654435761u) >> (32 - kHashBits);
+}
+
+} // namespace
+
+
+std::uint64_t CompressedStore::Size() const {
+	return size_;
+}
+
+std::uint64_t CompressedStore::RawSize() const {
+	return raw_size_;
+}
+
+std::uint64_t CompressedStore::Put(const std::vector<char>& bytes) {
+	Entry entry{Compress(bytes), bytes.size()};
+	size_ += entry.bytes.size();
+	raw_size_ += entry.raw_size;
+
+	if (free_ids_.empty()) {
+		entries_.push_back(std::move(entry));
+		return entries_.size() - 1;
+	}
+
+	auto id = free_ids_.back();
+	free_ids_.pop_back();
+	entries_[id] = std::move(entry);
+	return id;
+}
+
+std::vector<char> CompressedStore::Take(std::uint64_t id) {
+	auto& entry = entries_[id];
+	auto bytes = Decompress(entry.bytes, entry.raw_size);
+	Drop(id);
+	return bytes;
+}
+
+void CompressedStore::Drop(std::uint64_t id) {
+	auto& entry = entries_[id];
+	size_ -= entry.bytes.size();
+	raw_size_ -= entry.raw_size;
+	entry = {};
+	free_ids_.push_back(id);
+}
+
+std::vector<char> CompressedStore::Compress(const std::vector<char>& bytes) {
+	// LZ77 with a hash table of recent positions. The output is a list
+	// of sequences: literal count, literals, match length and offset.
+	// The last sequence only has literals.
+	std::vector<char> out;
+	std::vector<std::size_t> table(std::size_t(1) << kHashBits, 0);
+
+	auto size = bytes.size();
+	std::size_t anchor = 0;
+	std::size_t pos = 0;
+	while (pos + kMinMatch <= size) {
+		auto& slot = table[HashSequence(&bytes[pos])];
+		auto candidate = slot;
+		// Note: positions are stored +1, so zero is empty
+		slot = pos + 1;
+
+		if (!candidate ||
+			std::memcmp(&bytes[candidate - 1], &bytes[pos], kMinMatch) != 0)
+		{
+			++pos;
+			continue;
+		}
+
+		auto match = candidate - 1;
+		auto length = kMinMatch;
+		while (pos + length < size && bytes[match + length] == bytes[pos + length]) {
+			++length;
+		}
+
+		WriteVarint(out, pos - anchor);
+		out.insert(out.end(), bytes.begin() + anchor, bytes.begin() + pos);
+		WriteVarint(out, length - kMinMatch);
+		WriteVarint(out, pos - match);
+
+		pos += length;
+		anchor = pos;
+	}
+
+	WriteVarint(out, size - anchor);
+	out.insert(out.end(), bytes.begin() + anchor, bytes.end());
+	return out;
+}
+
+std::vector<char> CompressedStore::Decompress(
+	const std::vector<char>& bytes, std::size_t raw_size)
+{
+	std::vector<char> out;
+	out.reserve(raw_size);
+
+	// Note: every field is checked against the input and the expected
+	// output size, so corrupted buffers cannot read or write out of bounds.
+	std::size_t pos = 0;
+	while (true) {
+		auto literals = ReadVarint(bytes, pos);
+		if (literals > bytes.size() - pos ||
+			literals > raw_size - out.size())
+		{
+			Corrupted();
+		}
+		out.insert(out.end(), bytes.begin() + pos, bytes.begin() + pos + literals);
+		pos += literals;
+		if (pos == bytes.size()) {
+			break;
+		}
+
+		auto length = ReadVarint(bytes, pos);
+		auto offset = ReadVarint(bytes, pos);
+		if (raw_size - out.size() < kMinMatch ||
+			length > raw_size - out.size() - kMinMatch ||
+			offset == 0 || offset > out.size())
+		{
+			Corrupted();
+		}
+		length += kMinMatch;
+
+		// Note: matches can overlap their own output
+		auto from = out.size() - offset;
+		for (std::size_t i = 0; i < length; ++i) {
+			out.push_back(out[from + i]);
+		}
+	}
+	if (out.size() != raw_size) {
+		Corrupted();
+	}
+	return out;
+}
+
+} // namespace undoable
@@ -0,0 +1,63 @@
+#include "undoable/ComputedProperty.h"
+#include <algorithm>
+#include <cassert>
+
+
+namespace undoable {
+
+// ComputedPropertyBase::Dependencies
+
+ComputedPropertyBase::Dependencies::Dependencies(const PropertyOwner* owner)
+	: owner_(owner)
+{}
+
+void ComputedPropertyBase::Dependencies::Record(const Property* property) {
+	// Note: a fragment is notified when any of its properties change,
+	// so the outermost fragment stands for the property.
+	while (property->owner_ != owner_) {
+		property = dynamic_cast<const Property*>(property->owner_);
+		assert(property &&
+			"Computed properties can only depend on properties of their owner");
+		if (!property) {
+			return;
+		}
+	}
+	properties_.push_back(property);
+}
+
+
+// ComputedPropertyBase
+
+ComputedPropertyBase::ComputedPropertyBase(PropertyOwner* owner)
+	: Property(owner)
+{
+	owner->has_computed_ = true;
+}
+
+void ComputedPropertyBase::OnDependencyChange(Property* property) {
+	if (valid_ && std::find(dependencies_.begin(), dependencies_.end(),
+		property) != dependencies_.end())
+	{
+		Invalidate();
+	}
+}
+
+bool ComputedPropertyBase::IsValid() const {
+	return valid_;
+}
+
+void ComputedPropertyBase::Invalidate() {
+	if (valid_) {
+		valid_ = false;
+		dependencies_.clear();
+		// Note: computed properties depending on this one are invalidated too
+		owner_->InvalidateComputed(this);
+	}
+}
+
+void ComputedPropertyBase::Validate(Dependencies& dependencies) const {
+	dependencies_ = std::move(dependencies.properties_);
+	valid_ = true;
+}
+
+} // namespace undoable
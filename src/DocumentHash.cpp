@@ -0,0 +1,115 @@
+#include "undoable/DocumentHash.h"
+#include "undoable/Factory.h"
+#include "undoable/Hash.h"
+#include <unordered_set>
+
+
+namespace undoable {
+
+DocumentHash::DocumentHash(Factory& factory)
+	: history_(factory.GetHistory())
+{
+	factory.ForEachObject([this](Object* object) {
+		if (object->IsCreated()) {
+			Add(object);
+		}
+	});
+	history_.AddListener(this);
+}
+
+DocumentHash::~DocumentHash() {
+	history_.RemoveListener(this);
+}
+
+std::uint64_t DocumentHash::Get() const {
+	return hash_;
+}
+
+std::uint64_t DocumentHash::GetObjectHash(Object* object) const {
+	auto it = objects_.find(object);
+	return it == objects_.end() ? 0 : it->second;
+}
+
+void DocumentHash::OnChanges(const ChangeSet& changes) {
+	for (auto* object : changes.destroyed) {
+		Remove(object);
+	}
+	// Note: properties of created objects are not cached yet,
+	// they are hashed once by Add().
+	std::unordered_set<const Property*> updated;
+	for (auto* property : changes.modified) {
+		if (updated.insert(property).second) {
+			Update(property);
+		}
+	}
+	for (auto* object : changes.created) {
+		Add(object);
+	}
+}
+
+void DocumentHash::Add(Object* object) {
+	std::uint64_t hash = 0;
+	if (auto* last = object->last_property_) {
+		for (auto* p = last->next_property_;; p = p->next_property_) {
+			auto property_hash = p->Hash();
+			properties_[p] = Entry{object, property_hash};
+			hash += Contribution(p, property_hash);
+			if (p == last) {
+				break;
+			}
+		}
+	}
+	objects_[object] = hash;
+	hash_ += Contribution(object, hash);
+}
+
+void DocumentHash::Remove(Object* object) {
+	auto it = objects_.find(object);
+	if (it == objects_.end()) {
+		return;
+	}
+	hash_ -= Contribution(object, it->second);
+	objects_.erase(it);
+
+	if (auto* last = object->last_property_) {
+		for (auto* p = last->next_property_;; p = p->next_property_) {
+			properties_.erase(p);
+			if (p == last) {
+				break;
+			}
+		}
+	}
+}
+
+void DocumentHash::Update(Property* property) {
+	auto it = properties_.find(property);
+	while (it == properties_.end()) {
+		// Members of fragments are hashed by their fragment
+		property = dynamic_cast<Property*>(property->owner_);
+		if (!property) {
+			return;
+		}
+		it = properties_.find(property);
+	}
+
+	auto& entry = it->second;
+	auto hash = property->Hash();
+	if (hash == entry.hash) {
+		return;
+	}
+
+	auto& object_hash = objects_[entry.object];
+	hash_ -= Contribution(entry.object, object_hash);
+	object_hash -= Contribution(property, entry.hash);
+	object_hash += Contribution(property, hash);
+	hash_ += Contribution(entry.object, object_hash);
+	entry.hash = hash;
+}
+
+std::uint64_t DocumentHash::Contribution(
+	const void* key, std::uint64_t hash)
+{
+	return HashCombine(HashValue(key), hash);
+}
+
+} // namespace undoable
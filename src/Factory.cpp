@@ -1,10 +1,36 @@
 #include "undoable/Factory.h"
+#include <algorithm>
+#include <cassert>
+#include "undoable/Builder.h"
 
 
 namespace undoable {
 
+// Factory::BulkLoad
+
+Factory::BulkLoad::BulkLoad(Factory& factory, bool defer_on_create)
+	: factory_(factory)
+{
+	factory_.history_.BeginBulkLoad();
+	factory_.defer_on_create_ = defer_on_create;
+}
+
+Factory::BulkLoad::~BulkLoad() {
+	factory_.defer_on_create_ = false;
+	for (auto* obj : factory_.deferred_) {
+		obj->SetHistory(&factory_.history_);
+		obj->ApplyStatus(true);
+	}
+	factory_.deferred_.clear();
+	factory_.history_.EndBulkLoad();
+}
+
+
+// Factory
+
 Factory::~Factory() {
 	history_.Clear();
+	history_.ReclaimAll();
 	while (auto* p = NextObject()) {
 		Object::Destruct(p);
 	}
@@ -14,6 +40,58 @@ History& Factory::GetHistory() {
 	return history_;
 }
 
+void Factory::Attach(Builder& builder) {
+	if (builder.IsEmpty()) {
+		return;
+	}
+
+	// Splice the ring of the builder before the head
+	auto* first = builder.head_.next_object_;
+	auto* last = builder.head_.prev_object_;
+	ObjectBase::Link(&builder.head_, &builder.head_);
+	ObjectBase::Link(head_.prev_object_, first);
+	ObjectBase::Link(last, &head_);
+
+	for (auto* obj : builder.objects_) {
+		obj->SetHistory(&history_);
+	}
+
+	history_.Stage(MakeUnique<Object::BatchStatusChange>(
+		std::move(builder.objects_), true));
+	builder.objects_.clear();
+}
+
+void Factory::DestroyObjects(std::vector<Object*> objs) {
+	std::unordered_set<const PropertyOwner*> owners;
+	auto last = std::remove_if(objs.begin(), objs.end(), [&](Object* obj) {
+		assert(obj->GetHistory() == &history_ && "Object of another Factory");
+		return !obj->IsCreated() || !owners.insert(obj).second;
+	});
+	objs.erase(last, objs.end());
+	if (objs.empty()) {
+		return;
+	}
+
+	history_.BeginGroup();
+	for (auto* obj : objs) {
+		// Note: owning properties reset earlier might have destroyed it
+		if (obj->IsCreated()) {
+			obj->DestroyMembers(owners);
+		}
+	}
+	history_.EndGroup();
+
+	// Note: owning properties might have destroyed some of the objects
+	last = std::remove_if(objs.begin(), objs.end(), [](Object* obj) {
+		return !obj->IsCreated();
+	});
+	objs.erase(last, objs.end());
+	if (!objs.empty()) {
+		history_.StageDestroy(MakeUnique<Object::BatchStatusChange>(
+			std::move(objs), false));
+	}
+}
+
 void Factory::LinkBack(ObjectBase* node) {
 	ObjectBase::Link(head_.prev_object_, node);
 	ObjectBase::Link(node, &head_);
@@ -13,9 +13,26 @@ void Fragment::OnReset() {
 	ResetAllProperties();
 }
 
+void Fragment::Capture(Captures& captures) const {
+	CaptureAllProperties(captures);
+}
+
+void Fragment::Spill(SpillWriter& writer) {
+	SpillAllProperties(writer);
+}
+
+void Fragment::Reload(SpillReader& reader) {
+	ReloadAllProperties(reader);
+}
+
+std::uint64_t Fragment::Hash() const {
+	return HashAllProperties();
+}
+
 void Fragment::OnPropertyChange(Property* property) {
 	// Note: by default we don't propagate the change of the actual property,
 	// just for the `Fragment`.
+	owner_->InvalidateComputed(this);
 	owner_->OnPropertyChange(this);
 }
 
@@ -23,4 +40,14 @@ void Fragment::ApplyPropertyChange(UniquePtr<Command> command) {
 	owner_->ApplyPropertyChange(std::move(command));
 }
 
+void Fragment::IncrementVersion() {
+	PropertyOwner::IncrementVersion();
+	++version_;
+	owner_->IncrementVersion();
+}
+
+void Fragment::TrackPropertyChange(Property* property) {
+	owner_->TrackPropertyChange(property);
+}
+
 } // namespace undoable
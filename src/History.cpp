@@ -1,22 +1,121 @@
 #include "undoable/History.h"
+#include <algorithm>
 #include <cassert>
+#include <iterator>
+#include "undoable/Spill.h"
+#include "undoable/ThreadPool.h"
 
 
 namespace undoable {
 
+namespace {
+
+// Shorter runs of partitioned commands are not worth distributing.
+const std::size_t kMinParallelRun = 256;
+
+// Number of commands destroyed between checks of the reclaim budget.
+const std::size_t kReclaimStep = 64;
+
+} // namespace
+
 
 // Transaction
 
+Transaction::Transaction(Transaction&& other)
+	: commands_(std::move(other.commands_))
+	, reverse_(other.reverse_)
+	, sealed_(other.sealed_)
+	, spilled_(other.spilled_)
+	, store_(other.store_)
+	, spill_id_(other.spill_id_)
+{
+	other.commands_.clear();
+	other.spilled_ = false;
+	other.store_ = nullptr;
+}
+
+Transaction& Transaction::operator=(Transaction&& other) {
+	if (this != &other) {
+		Clear();
+		commands_ = std::move(other.commands_);
+		reverse_ = other.reverse_;
+		sealed_ = other.sealed_;
+		spilled_ = other.spilled_;
+		store_ = other.store_;
+		spill_id_ = other.spill_id_;
+		other.commands_.clear();
+		other.spilled_ = false;
+		other.store_ = nullptr;
+	}
+	return *this;
+}
+
 Transaction::~Transaction() {
 	Clear();
 }
 
 void Transaction::Clear() {
+	if (store_) {
+		store_->Drop(spill_id_);
+		store_ = nullptr;
+	}
+	spilled_ = false;
+
 	// Note: destruction order is important
 	for (auto& cmd : commands_) {
 		cmd = nullptr;
 	}
 	commands_.clear();
+	sealed_ = 0;
+}
+
+bool Transaction::ClearFront(std::size_t count) {
+	if (store_) {
+		store_->Drop(spill_id_);
+		store_ = nullptr;
+	}
+	spilled_ = false;
+	while (count-- > 0 && !commands_.empty()) {
+		commands_.front() = nullptr;
+		commands_.pop_front();
+	}
+	return commands_.empty();
+}
+
+std::size_t Transaction::Size() const {
+	return commands_.size();
+}
+
+void Transaction::Seal() {
+	sealed_ = commands_.size();
+}
+
+void Transaction::Truncate(std::size_t size) {
+	while (commands_.size() > size) {
+		commands_.back()->Apply(!reverse_);
+		commands_.back() = nullptr;
+		commands_.pop_back();
+	}
+	sealed_ = std::min(sealed_, size);
+}
+
+void Transaction::Append(Transaction other) {
+	assert(reverse_ == other.reverse_ && "Transactions are not aligned");
+	Reload();
+	other.Reload();
+	for (auto& cmd : other.commands_) {
+		if (!commands_.empty() && commands_.back()->Merge(*cmd)) {
+			continue;
+		}
+		commands_.push_back(std::move(cmd));
+	}
+}
+
+void Transaction::Compact() {
+	Reload();
+	for (auto& cmd : commands_) {
+		cmd->Compact();
+	}
 }
 
 bool Transaction::IsEmpty() const {
@@ -25,35 +124,202 @@ bool Transaction::IsEmpty() const {
 
 void Transaction::Apply(UniquePtr<Command> command) {
 	command->Apply(reverse_);
+	if (commands_.size() > sealed_ && commands_.back()->Merge(*command)) {
+		return;
+	}
 	commands_.push_back(std::move(command));
 }
 
-void Transaction::Reverse() {
+void Transaction::Spill(SpillStore& store) {
+	if (spilled_ || commands_.empty()) {
+		return;
+	}
+
+	SpillWriter writer;
+	Spill(writer);
+	spilled_ = true;
+
+	auto bytes = writer.Take();
+	if (bytes.empty()) {
+		return;
+	}
+
+	auto id = store.Put(bytes);
+	if (id == SpillStore::kNotStored) {
+		// Note: the payloads stay in memory if the store fails
+		SpillReader reader(std::move(bytes));
+		Reload(reader);
+		spilled_ = false;
+		return;
+	}
+	store_ = &store;
+	spill_id_ = id;
+}
+
+void Transaction::Reload() {
+	if (!spilled_) {
+		return;
+	}
+
+	std::vector<char> bytes;
+	if (store_) {
+		bytes = store_->Take(spill_id_);
+		store_ = nullptr;
+	}
+	spilled_ = false;
+
+	SpillReader reader(std::move(bytes));
+	Reload(reader);
+}
+
+bool Transaction::IsSpilled() const {
+	return spilled_;
+}
+
+void Transaction::Spill(SpillWriter& writer) {
+	for (auto& cmd : commands_) {
+		cmd->Spill(writer);
+	}
+}
+
+void Transaction::Reload(SpillReader& reader) {
+	for (auto& cmd : commands_) {
+		cmd->Reload(reader);
+	}
+}
+
+void Transaction::Reverse(ThreadPool* pool) {
+	Reload();
 	reverse_ = !reverse_;
 	commands_.reverse();
+
+	if (!pool) {
+		for (auto& cmd : commands_) {
+			cmd->Apply(reverse_);
+		}
+		return;
+	}
+
+	// Note: commands without a partition act as barriers between runs
+	std::vector<Command*> run;
 	for (auto& cmd : commands_) {
-		cmd->Apply(reverse_);
+		if (cmd->Partition()) {
+			run.push_back(cmd.get());
+			continue;
+		}
+
+		ApplyRun(run, *pool);
+		run.clear();
+		cmd->ApplyParallel(reverse_, *pool);
+	}
+	ApplyRun(run, *pool);
+}
+
+void Transaction::ApplyRun(const std::vector<Command*>& run, ThreadPool& pool) {
+	if (run.size() < kMinParallelRun) {
+		for (auto* cmd : run) {
+			cmd->Apply(reverse_);
+		}
+		return;
+	}
+
+	// Commands of a partition keep their relative order
+	std::unordered_map<const void*, std::size_t> index;
+	std::vector<std::vector<Command*>> partitions;
+	for (auto* cmd : run) {
+		auto result = index.emplace(cmd->Partition(), partitions.size());
+		if (result.second) {
+			partitions.emplace_back();
+		}
+		partitions[result.first->second].push_back(cmd);
+	}
+
+	auto reverse = reverse_;
+	pool.Run(partitions.size(), [&](std::size_t i) {
+		for (auto* cmd : partitions[i]) {
+			cmd->ApplyPartitioned(reverse);
+		}
+	});
+
+	for (auto* cmd : run) {
+		cmd->Notify();
 	}
 }
 
 
+// History::Group
+
+History::Group::Group(Transaction transaction)
+	: transaction_(std::move(transaction))
+{}
+
+void History::Group::Apply(bool reverse) {
+	if (applied_) {
+		applied_ = false;
+		return;
+	}
+	transaction_.Reverse();
+}
+
+void History::Group::Spill(SpillWriter& writer) {
+	transaction_.Spill(writer);
+}
+
+void History::Group::Reload(SpillReader& reader) {
+	transaction_.Reload(reader);
+}
+
+
+// ChangeSet
+
+bool ChangeSet::IsEmpty() const {
+	return created.empty() && destroyed.empty() && modified.empty() &&
+		changed.empty();
+}
+
+
 // History
 
 History::~History() {
 	Clear();
+	ReclaimAll();
 }
 
 void History::Stage(UniquePtr<Command> command) {
+	if (bulk_load_) {
+		command->Apply(false);
+		return;
+	}
+	if (grouping_) {
+		group_.Apply(std::move(command));
+		return;
+	}
 	stage_.Apply(std::move(command));
 }
 
+void History::StageDestroy(UniquePtr<Command> command) {
+	if (bulk_load_) {
+		command->Apply(false);
+		bulk_destroyed_.push_back(std::move(command));
+		return;
+	}
+	Stage(std::move(command));
+}
+
 void History::Unstage() {
-	stage_.Reverse();
+	savepoints_.clear();
+	if (stage_.IsEmpty()) {
+		return;
+	}
+
+	stage_.Reverse(pool_);
 	stage_.Clear();
 	stage_.Reverse();
+	DeliverChanges();
 }
 
 void History::Commit() {
+	savepoints_.clear();
 	if (stage_.IsEmpty()) {
 		// Empty commits are not allowed
 		return;
@@ -62,6 +328,28 @@ void History::Commit() {
 	undo_.emplace_back(std::move(stage_));
 	stage_ = {};
 	ClearRedo();
+	SpillCold();
+	DeliverChanges();
+}
+
+std::size_t History::Mark() {
+	assert(!bulk_load_ && !grouping_ && "Cannot mark a savepoint here");
+	stage_.Seal();
+	savepoints_.push_back(stage_.Size());
+	return savepoints_.size() - 1;
+}
+
+void History::RollbackTo(std::size_t savepoint) {
+	assert(!bulk_load_ && !grouping_ && "Cannot roll back here");
+	assert(savepoint < savepoints_.size() && "Invalid savepoint");
+	savepoints_.resize(savepoint + 1);
+	stage_.Truncate(savepoints_.back());
+}
+
+void History::Release(std::size_t savepoint) {
+	assert(!bulk_load_ && !grouping_ && "Cannot release a savepoint here");
+	assert(savepoint < savepoints_.size() && "Invalid savepoint");
+	savepoints_.resize(savepoint);
 }
 
 void History::Undo() {
@@ -69,11 +357,12 @@ void History::Undo() {
 		return;
 	}
 
-	undo_.back().Reverse();
+	undo_.back().Reverse(pool_);
 
 	auto it = undo_.end();
 	--it;
 	redo_.splice(redo_.begin(), undo_, it);
+	DeliverChanges();
 }
 
 void History::Redo() {
@@ -81,19 +370,111 @@ void History::Redo() {
 		return;
 	}
 
-	redo_.front().Reverse();
+	redo_.front().Reverse(pool_);
 	undo_.splice(undo_.end(), redo_, redo_.begin());
+	DeliverChanges();
+}
+
+std::size_t History::Revision() const {
+	return undo_.size();
+}
+
+void History::Squash(std::size_t from, std::size_t to) {
+	assert(from <= to && to <= undo_.size() && "Invalid revisions");
+	if (to - from < 2) {
+		return;
+	}
+
+	auto first = std::next(undo_.begin(), from);
+	auto last = std::next(first, to - from);
+	for (auto it = std::next(first); it != last;) {
+		first->Append(std::move(*it));
+		it = undo_.erase(it);
+	}
+	first->Compact();
+
+	// Note: the merged transaction was reloaded, spill it again if cold
+	if (spill_store_ && from + hot_depth_ < undo_.size()) {
+		first->Spill(*spill_store_);
+	}
 }
 
 void History::ClearRedo() {
 	while (!redo_.empty()) {
-		redo_.pop_back();
+		Discard(redo_, std::prev(redo_.end()));
 	}
 }
 
 void History::ClearUndo() {
 	while (!undo_.empty()) {
-		undo_.pop_front();
+		Discard(undo_, undo_.begin());
+	}
+}
+
+void History::Discard(std::list<Transaction>& list,
+	std::list<Transaction>::iterator it)
+{
+	if (deferred_reclaim_) {
+		reclaim_.splice(reclaim_.end(), list, it);
+	} else {
+		list.erase(it);
+	}
+}
+
+void History::SetSpillStore(SpillStore* store, std::size_t hot_depth) {
+	for (auto& transaction : undo_) {
+		transaction.Reload();
+	}
+	spill_store_ = store;
+	hot_depth_ = hot_depth;
+	SpillCold();
+}
+
+void History::SpillCold() {
+	if (!spill_store_ || undo_.size() <= hot_depth_) {
+		return;
+	}
+
+	// Note: reloaded transactions are always on top of the spilled ones
+	auto it = undo_.end();
+	std::advance(it, -static_cast<std::ptrdiff_t>(hot_depth_));
+	while (it != undo_.begin()) {
+		--it;
+		if (it->IsSpilled()) {
+			break;
+		}
+		it->Spill(*spill_store_);
+		if (!it->IsSpilled()) {
+			// The store failed, older transactions are tried next time
+			break;
+		}
+	}
+}
+
+void History::SetDeferredReclaim(bool deferred) {
+	deferred_reclaim_ = deferred;
+}
+
+bool History::Reclaim(std::chrono::microseconds budget) {
+	using Clock = std::chrono::steady_clock;
+	auto deadline = Clock::now() + budget;
+
+	// Note: large transactions are destroyed in steps,
+	// so the budget is also kept for them.
+	while (!reclaim_.empty()) {
+		if (reclaim_.front().ClearFront(kReclaimStep)) {
+			reclaim_.pop_front();
+		}
+		if (Clock::now() >= deadline) {
+			break;
+		}
+	}
+	return reclaim_.empty();
+}
+
+void History::ReclaimAll() {
+	while (!reclaim_.empty()) {
+		reclaim_.pop_front();
 	}
 }
 
@@ -115,4 +496,123 @@ bool History::CanCommit() const {
 	return !stage_.IsEmpty();
 }
 
+void History::SetThreadPool(ThreadPool* pool) {
+	pool_ = pool;
+}
+
+void History::BeginGroup() {
+	assert(!grouping_ && "Groups cannot be nested");
+	grouping_ = true;
+}
+
+void History::EndGroup() {
+	assert(grouping_ && "Group is not started");
+	grouping_ = false;
+	if (!group_.IsEmpty()) {
+		stage_.Apply(MakeUnique<Group>(std::move(group_)));
+		group_ = {};
+	}
+}
+
+void History::BeginBulkLoad() {
+	assert(!bulk_load_ && "Bulk load is already in progress");
+	Clear();
+	bulk_load_ = true;
+}
+
+void History::EndBulkLoad() {
+	assert(bulk_load_ && "Bulk load is not in progress");
+	bulk_load_ = false;
+	DeliverChanges();
+	bulk_destroyed_.clear();
+}
+
+bool History::IsBulkLoading() const {
+	return bulk_load_;
+}
+
+void History::AddListener(ChangeListener* listener) {
+	listeners_.push_back(listener);
+}
+
+void History::RemoveListener(ChangeListener* listener) {
+	listeners_.erase(
+		std::remove(listeners_.begin(), listeners_.end(), listener),
+		listeners_.end());
+}
+
+void History::TrackCreate(Object* object) {
+	TrackStatus(object, true);
+}
+
+void History::TrackDestroy(Object* object) {
+	TrackStatus(object, false);
+}
+
+void History::TrackStatus(Object* object, bool exists) {
+	if (listeners_.empty()) {
+		return;
+	}
+
+	auto result = object_changes_.emplace(object, ObjectChange{!exists, exists});
+	if (result.second) {
+		changed_objects_.push_back(object);
+	} else {
+		result.first->second.exists = exists;
+	}
+}
+
+void History::TrackChange(Object* object, Property* property) {
+	if (listeners_.empty()) {
+		return;
+	}
+
+	if (property_changes_.insert(property).second) {
+		changed_properties_.emplace_back(object, property);
+	}
+}
+
+void History::DeliverChanges() {
+	ChangeSet changes;
+
+	std::unordered_set<Object*> changed;
+
+	for (auto* object : changed_objects_) {
+		auto& change = object_changes_[object];
+		if (!change.existed && change.exists) {
+			changes.created.push_back(object);
+		} else if (change.existed && !change.exists) {
+			changes.destroyed.push_back(object);
+		} else if (change.existed && change.exists) {
+			changed.insert(object);
+			changes.changed.push_back(object);
+		}
+	}
+
+	for (auto& item : changed_properties_) {
+		// Note: objects created and destroyed in the same change set
+		// might already be deleted.
+		auto it = object_changes_.find(item.first);
+		if (it == object_changes_.end()) {
+			if (changed.insert(item.first).second) {
+				changes.changed.push_back(item.first);
+			}
+			changes.modified.push_back(item.second);
+		} else if (it->second.existed || it->second.exists) {
+			changes.modified.push_back(item.second);
+		}
+	}
+
+	changed_objects_.clear();
+	object_changes_.clear();
+	changed_properties_.clear();
+	property_changes_.clear();
+
+	// Note: listeners are allowed to remove themselves
+	auto listeners = listeners_;
+	for (auto* listener : listeners) {
+		listener->OnChanges(changes);
+	}
+}
+
 } // namespace undoable
@@ -1,4 +1,5 @@
 #include "undoable/ListProperty.h"
+#include "undoable/Hash.h"
 
 
 namespace undoable {
@@ -79,17 +80,39 @@ void ListNodeBase::Relink::Apply(bool reverse) {
 
 void ListNodeOwner::RegisterListNode(ListNodeBase* node) {
 	if (last_node_) {
+		node->next_node_ = last_node_->next_node_;
 		last_node_->next_node_ = node;
-		last_node_ = node;
 	} else {
-		first_node_ = node;
-		last_node_ = node;
+		node->next_node_ = node;
 	}
+	last_node_ = node;
 }
 
 void ListNodeOwner::UnlinkAllNodes() {
-	for (auto* p = first_node_; p; p = p->next_node_) {
+	if (!last_node_) {
+		return;
+	}
+	for (auto* p = last_node_->next_node_;; p = p->next_node_) {
 		p->Unlink();
+		if (p == last_node_) {
+			break;
+		}
+	}
+}
+
+void ListNodeOwner::UnlinkNodesExcept(
+	const std::unordered_set<const PropertyOwner*>& owners)
+{
+	if (!last_node_) {
+		return;
+	}
+	for (auto* p = last_node_->next_node_;; p = p->next_node_) {
+		if (p->parent_ && !owners.count(p->Owner())) {
+			p->Unlink();
+		}
+		if (p == last_node_) {
+			break;
+		}
 	}
 }
 
@@ -100,4 +123,13 @@ ListPropertyBase::ListPropertyBase(PropertyOwner* owner)
 	: Property(owner)
 {}
 
+std::uint64_t ListPropertyBase::Hash() const {
+	// Note: the nodes are identified by their address
+	std::uint64_t h = 0;
+	for (auto* p = head_.next_; p != &head_; p = p->next_) {
+		h = HashCombine(h, HashValue(static_cast<const void*>(p)));
+	}
+	return h;
+}
+
 } // namespace undoable
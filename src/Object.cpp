@@ -1,6 +1,7 @@
 #include <cassert>
 #include <iostream>
 #include "undoable/Object.h"
+#include "undoable/Spill.h"
 
 
 namespace undoable {
@@ -31,31 +32,38 @@ bool ObjectBase::InheritanceOrderCheck() const {
 // Object
 
 Object::~Object() {
-	assert(status_ != Status::kConstructing &&
+	assert(GetStatus() != Status::kConstructing &&
 		"Object was not created through Factory");
-	assert(status_ == Status::kDestructing &&
+	assert(GetStatus() == Status::kDestructing &&
 		"Object was not destructed through Destroy()");
 }
 
 void Object::ApplyPropertyChange(UniquePtr<Command> command) {
-	assert(status_ != Status::kOnCreate &&
+	assert(GetStatus() != Status::kOnCreate &&
 		"Cannot change properties in OnCreate()");
-	assert(status_ != Status::kOnDestroy &&
+	assert(GetStatus() != Status::kOnDestroy &&
 		"Cannot change properties in OnDestroy()");
-	assert(status_ != Status::kDestroyed &&
+	assert(GetStatus() != Status::kDestroyed &&
 		"Cannot change properties on a destroyed object");
 	assert(!on_change_ &&
 		"Cannot change properties via OnPropertyChange()");
 
 	if (!on_change_) {
-		if (history_ && status_ == Status::kCreated) {
-			history_->Stage(std::move(command));
-		} else if (!history_) {
+		auto* history = GetHistory();
+		if (history && GetStatus() == Status::kCreated) {
+			history->Stage(std::move(command));
+		} else if (!history) {
 			command->Apply(false);
 		}
 	}
 }
 
+void Object::TrackPropertyChange(Property* property) {
+	if (auto* history = GetHistory()) {
+		history->TrackChange(this, property);
+	}
+}
+
 void Object::DestroyMembers() {
 	// Note: this is a bit unlike how a destructor would work,
 	// however this order trivially breaks owning list cycles.
@@ -64,47 +72,92 @@ void Object::DestroyMembers() {
 	ResetAllProperties(); // 3
 }
 
+void Object::DestroyMembers(
+	const std::unordered_set<const PropertyOwner*>& destroyed)
+{
+	// Note: lists and references of other destroyed objects are
+	// reset by their owners, so they are left alone here.
+	UnlinkNodesExcept(destroyed); // 1
+	ResetReferencesExcept(destroyed); // 2
+	ResetAllProperties(); // 3
+}
+
 void Object::Destroy() {
-	assert(history_ && "History is not set");
-	assert(status_ != Status::kOnCreate &&
+	assert(GetHistory() && "History is not set");
+	assert(GetStatus() != Status::kOnCreate &&
 		"Cannot destroy in OnCreate()");
-	assert(status_ != Status::kOnDestroy &&
+	assert(GetStatus() != Status::kOnDestroy &&
 		"Cannot destroy in OnDestroy()");
-	assert(status_ != Status::kDestroyed &&
+	assert(GetStatus() != Status::kDestroyed &&
 		"Cannot destroy a destroyed object");
 
-	if (history_ && status_ == Status::kCreated) {
+	if (GetHistory() && GetStatus() == Status::kCreated) {
 		DestroyMembers();
-		history_->Stage(MakeUnique<StatusChange>(this, false));
+		GetHistory()->StageDestroy(MakeUnique<StatusChange>(this, false));
 	}
 }
 
 void Object::Destruct(Object* obj) {
 	// Note: destructor can freely change properties just like the ctor
-	obj->history_ = nullptr;
-	obj->status_ = Status::kDestructing;
+	obj->SetHistory(nullptr);
+	obj->SetStatus(Status::kDestructing);
 	delete obj;
 }
 
 void Object::Init(History* history) {
-	history_ = history;
-	history_->Stage(MakeUnique<StatusChange>(this, true));
+	SetHistory(history);
+	if (history->IsBulkLoading()) {
+		ApplyStatus(true);
+	} else {
+		history->Stage(MakeUnique<StatusChange>(this, true));
+	}
+}
+
+void Object::ApplyStatus(bool create) {
+	if (create) {
+		SetStatus(Status::kOnCreate);
+		OnCreate();
+		SetStatus(Status::kCreated);
+		GetHistory()->TrackCreate(this);
+	} else {
+		SetStatus(Status::kOnDestroy);
+		OnDestroy();
+		SetStatus(Status::kDestroyed);
+		GetHistory()->TrackDestroy(this);
+	}
+}
+
+History* Object::GetHistory() const {
+	return reinterpret_cast<History*>(header_ & ~kStatusMask);
+}
+
+void Object::SetHistory(History* history) {
+	header_ = reinterpret_cast<std::uintptr_t>(history) |
+		(header_ & kStatusMask);
+}
+
+Object::Status Object::GetStatus() const {
+	return static_cast<Status>(header_ & kStatusMask);
+}
+
+void Object::SetStatus(Status status) {
+	header_ = (header_ & ~kStatusMask) | static_cast<std::uintptr_t>(status);
 }
 
 bool Object::IsConstructing() const {
-	return status_ == Status::kConstructing;
+	return GetStatus() == Status::kConstructing;
 }
 
 bool Object::IsDestructing() const {
-	return status_ == Status::kDestructing;
+	return GetStatus() == Status::kDestructing;
 }
 
 bool Object::IsCreated() const {
-	return status_ == Status::kCreated;
+	return GetStatus() == Status::kCreated;
 }
 
 bool Object::IsDestroyed() const {
-	return status_ == Status::kDestroyed;
+	return GetStatus() == Status::kDestroyed;
 }
 
 
@@ -123,16 +176,68 @@ Object::StatusChange::~StatusChange() {
 }
 
 void Object::StatusChange::Apply(bool reverse) {
+	destructable_ = !(create_ ^ reverse);
+	obj_->ApplyStatus(create_ ^ reverse);
+}
+
+void Object::StatusChange::Spill(SpillWriter& writer) {
+	// Note: the object stays a tombstone until this command is reversed
+	if (destructable_) {
+		obj_->SpillAllProperties(writer);
+	}
+}
+
+void Object::StatusChange::Reload(SpillReader& reader) {
+	if (destructable_) {
+		obj_->ReloadAllProperties(reader);
+	}
+}
+
+
+// Object::BatchStatusChange
+
+Object::BatchStatusChange::BatchStatusChange(
+		std::vector<Object*> objs, bool create)
+	: objs_(std::move(objs))
+	, create_(create)
+	, destructable_(false)
+{}
+
+Object::BatchStatusChange::~BatchStatusChange() {
+	if (destructable_) {
+		for (auto* obj : objs_) {
+			Object::Destruct(obj);
+		}
+	}
+}
+
+void Object::BatchStatusChange::Apply(bool reverse) {
 	if (create_ ^ reverse) {
 		destructable_ = false;
-		obj_->status_ = Status::kOnCreate;
-		obj_->OnCreate();
-		obj_->status_ = Status::kCreated;
+		for (auto* obj : objs_) {
+			obj->ApplyStatus(true);
+		}
 	} else {
 		destructable_ = true;
-		obj_->status_ = Status::kOnDestroy;
-		obj_->OnDestroy();
-		obj_->status_ = Status::kDestroyed;
+		for (auto it = objs_.rbegin(); it != objs_.rend(); ++it) {
+			(*it)->ApplyStatus(false);
+		}
+	}
+}
+
+void Object::BatchStatusChange::Spill(SpillWriter& writer) {
+	if (destructable_) {
+		for (auto* obj : objs_) {
+			obj->SpillAllProperties(writer);
+		}
+	}
+}
+
+void Object::BatchStatusChange::Reload(SpillReader& reader) {
+	if (destructable_) {
+		for (auto* obj : objs_) {
+			obj->ReloadAllProperties(reader);
+		}
 	}
 }
 
@@ -1,4 +1,5 @@
 #include "undoable/Property.h"
+#include "undoable/Hash.h"
 
 
 namespace undoable {
@@ -12,7 +13,16 @@ Property::Property(PropertyOwner* owner)
 	owner->RegisterProperty(this);
 }
 
+std::uint32_t Property::Version() const {
+	return version_;
+}
+
 void Property::NotifyOwner() {
+	++version_;
+	owner_->IncrementVersion();
+	owner_->TrackPropertyChange(this);
+	owner_->InvalidateComputed(this);
+
 	auto old_value = owner_->on_change_;
 	owner_->on_change_ = true;
 	owner_->OnPropertyChange(this);
@@ -22,19 +32,97 @@ void Property::NotifyOwner() {
 
 // PropertyOwner
 
+std::uint32_t PropertyOwner::Version() const {
+	return properties_version_;
+}
+
+void PropertyOwner::IncrementVersion() {
+	++properties_version_;
+}
+
 void PropertyOwner::RegisterProperty(Property* property) {
 	if (last_property_) {
+		property->next_property_ = last_property_->next_property_;
 		last_property_->next_property_ = property;
-		last_property_ = property;
 	} else {
-		first_property_ = property;
-		last_property_ = property;
+		property->next_property_ = property;
 	}
+	last_property_ = property;
 }
 
 void PropertyOwner::ResetAllProperties() {
-	for (auto* p = first_property_; p; p = p->next_property_) {
+	if (!last_property_) {
+		return;
+	}
+	for (auto* p = last_property_->next_property_;; p = p->next_property_) {
 		p->OnReset();
+		if (p == last_property_) {
+			break;
+		}
+	}
+}
+
+std::uint64_t PropertyOwner::HashAllProperties() const {
+	std::uint64_t h = 0;
+	if (!last_property_) {
+		return h;
+	}
+	for (auto* p = last_property_->next_property_;; p = p->next_property_) {
+		h = HashCombine(h, p->Hash());
+		if (p == last_property_) {
+			break;
+		}
+	}
+	return h;
+}
+
+void PropertyOwner::CaptureAllProperties(Captures& captures) const {
+	if (!last_property_) {
+		return;
+	}
+	for (auto* p = last_property_->next_property_;; p = p->next_property_) {
+		p->Capture(captures);
+		if (p == last_property_) {
+			break;
+		}
+	}
+}
+
+void PropertyOwner::SpillAllProperties(SpillWriter& writer) {
+	if (!last_property_) {
+		return;
+	}
+	for (auto* p = last_property_->next_property_;; p = p->next_property_) {
+		p->Spill(writer);
+		if (p == last_property_) {
+			break;
+		}
+	}
+}
+
+void PropertyOwner::ReloadAllProperties(SpillReader& reader) {
+	if (!last_property_) {
+		return;
+	}
+	for (auto* p = last_property_->next_property_;; p = p->next_property_) {
+		p->Reload(reader);
+		if (p == last_property_) {
+			break;
+		}
+	}
+}
+
+void PropertyOwner::InvalidateComputed(Property* property) {
+	if (!has_computed_) {
+		return;
+	}
+	for (auto* p = last_property_->next_property_;; p = p->next_property_) {
+		if (p != property) {
+			p->OnDependencyChange(property);
+		}
+		if (p == last_property_) {
+			break;
+		}
 	}
 }
 
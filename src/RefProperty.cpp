@@ -1,16 +1,20 @@
 #include "undoable/RefProperty.h"
+#include "undoable/Hash.h"
 
 
 namespace undoable {
 
 
-// RefNode
+// RefLink
 
-void RefNode::LinkRef(RefNode* u, RefNode* v) {
+void RefLink::LinkRef(RefLink* u, RefLink* v) {
 	u->next_ref_ = v;
 	v->prev_ref_ = u;
 }
 
+
+// RefNode
+
 void RefNode::UnlinkRef() {
 	LinkRef(prev_ref_, next_ref_);
 	LinkRef(this, this);
@@ -21,9 +25,9 @@ void RefNode::UnlinkRef() {
 // Referable
 
 void Referable::LinkBack(RefPropertyBase* node) {
-	RefNode::LinkRef(node->prev_ref_, node->next_ref_);
-	RefNode::LinkRef(head_.prev_ref_, node);
-	RefNode::LinkRef(node, &head_);
+	RefLink::LinkRef(node->prev_ref_, node->next_ref_);
+	RefLink::LinkRef(head_.prev_ref_, node);
+	RefLink::LinkRef(node, &head_);
 	node->referable_ = this;
 }
 
@@ -34,6 +38,19 @@ void Referable::ResetAllReferences() {
 	}
 }
 
+void Referable::ResetReferencesExcept(
+	const std::unordered_set<const PropertyOwner*>& owners)
+{
+	for (auto* p = head_.next_ref_; p != &head_;) {
+		auto* ref = static_cast<RefPropertyBase*>(p);
+		p = p->next_ref_;
+		if (!owners.count(ref->owner_)) {
+			ref->SetReferable(nullptr);
+		}
+	}
+}
+
+
 // RefPropertyBase
 
 RefPropertyBase::RefPropertyBase(PropertyOwner* owner)
@@ -59,4 +76,13 @@ void RefPropertyBase::OnReset() {
 	SetReferable(nullptr);
 }
 
+void RefPropertyBase::Capture(Captures& captures) const {
+	captures.emplace_back(this, std::make_shared<const Referable*>(referable_));
+}
+
+std::uint64_t RefPropertyBase::Hash() const {
+	// Note: the target is identified by its address
+	return HashValue(static_cast<const void*>(referable_));
+}
+
 } // namespace undoable
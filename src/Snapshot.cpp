@@ -0,0 +1,137 @@
+#include "undoable/Snapshot.h"
+#include "undoable/Factory.h"
+#include "undoable/Hash.h"
+#include <cstdint>
+
+
+namespace undoable {
+
+
+// Snapshot
+
+std::size_t Snapshot::BucketIndex(const Object* object, std::size_t count) {
+	auto h = HashMix(reinterpret_cast<std::uintptr_t>(object));
+	return static_cast<std::size_t>(h & (count - 1));
+}
+
+bool Snapshot::Contains(const Object& object) const {
+	auto& bucket = *buckets_[BucketIndex(&object, buckets_.size())];
+	return bucket.count(&object) > 0;
+}
+
+std::size_t Snapshot::Size() const {
+	return size_;
+}
+
+const void* Snapshot::Find(
+	const Object& object, const Property& property) const
+{
+	auto& bucket = *buckets_[BucketIndex(&object, buckets_.size())];
+	auto it = bucket.find(&object);
+	if (it == bucket.end()) {
+		return nullptr;
+	}
+	for (auto& capture : *it->second) {
+		if (capture.first == &property) {
+			return capture.second.get();
+		}
+	}
+	return nullptr;
+}
+
+
+// SnapshotManager
+
+constexpr std::size_t SnapshotManager::kBucketSize;
+constexpr std::size_t SnapshotManager::kMinBuckets;
+
+SnapshotManager::SnapshotManager(Factory& factory)
+	: history_(factory.GetHistory())
+{
+	buckets_.reserve(kMinBuckets);
+	for (std::size_t i = 0; i < kMinBuckets; ++i) {
+		buckets_.push_back(std::make_shared<Bucket>());
+	}
+	published_.assign(kMinBuckets, false);
+	factory.ForEachObject([this](Object* object) {
+		if (object->IsCreated()) {
+			Capture(object);
+		}
+	});
+	history_.AddListener(this);
+}
+
+SnapshotManager::~SnapshotManager() {
+	history_.RemoveListener(this);
+}
+
+std::shared_ptr<const Snapshot> SnapshotManager::Pin() {
+	if (!current_) {
+		auto snapshot = std::make_shared<Snapshot>();
+		snapshot->buckets_.assign(buckets_.begin(), buckets_.end());
+		snapshot->size_ = size_;
+		published_.assign(buckets_.size(), true);
+		current_ = std::move(snapshot);
+	}
+	return current_;
+}
+
+void SnapshotManager::OnChanges(const ChangeSet& changes) {
+	for (auto* object : changes.destroyed) {
+		Erase(object);
+	}
+	for (auto* object : changes.changed) {
+		Capture(object);
+	}
+	for (auto* object : changes.created) {
+		Capture(object);
+	}
+	if (!changes.IsEmpty()) {
+		current_ = nullptr;
+	}
+}
+
+SnapshotManager::Bucket& SnapshotManager::Modify(const Object* object) {
+	auto index = Snapshot::BucketIndex(object, buckets_.size());
+	auto& bucket = buckets_[index];
+	if (published_[index]) {
+		bucket = std::make_shared<Bucket>(*bucket);
+		published_[index] = false;
+	}
+	return *bucket;
+}
+
+void SnapshotManager::Capture(const Object* object) {
+	auto captures = std::make_shared<Captures>();
+	object->CaptureAllProperties(*captures);
+	auto& slot = Modify(object)[object];
+	if (!slot) {
+		++size_;
+	}
+	slot = std::move(captures);
+	if (size_ > buckets_.size() * kBucketSize) {
+		Grow();
+	}
+}
+
+void SnapshotManager::Erase(const Object* object) {
+	size_ -= Modify(object).erase(object);
+}
+
+void SnapshotManager::Grow() {
+	std::vector<std::shared_ptr<Bucket>> buckets;
+	buckets.reserve(buckets_.size() * 2);
+	for (std::size_t i = 0; i < buckets_.size() * 2; ++i) {
+		buckets.push_back(std::make_shared<Bucket>());
+	}
+	for (auto& bucket : buckets_) {
+		for (auto& entry : *bucket) {
+			auto index = Snapshot::BucketIndex(entry.first, buckets.size());
+			buckets[index]->insert(entry);
+		}
+	}
+	buckets_ = std::move(buckets);
+	published_.assign(buckets_.size(), false);
+}
+
+} // namespace undoable
@@ -0,0 +1,154 @@
+#include "undoable/SpillFile.h"
+#include <iterator>
+#include <stdexcept>
+#include <sys/types.h>
+
+
+namespace undoable {
+
+namespace {
+
+// Note: offsets are 64-bit, `long` of std::fseek() is 32-bit on Windows
+// and on 32-bit targets, where fseeko() needs _FILE_OFFSET_BITS=64.
+bool Seek(std::FILE* file, std::uint64_t offset) {
+#ifdef _WIN32
+	return _fseeki64(file, static_cast<__int64>(offset), SEEK_SET) == 0;
+#else
+	return fseeko(file, static_cast<off_t>(offset), SEEK_SET) == 0;
+#endif
+}
+
+} // namespace
+
+
+SpillFile::SpillFile(const std::string& path) {
+	file_ = path.empty() ? std::tmpfile() : std::fopen(path.c_str(), "w+b");
+}
+
+SpillFile::~SpillFile() {
+	if (file_) {
+		std::fclose(file_);
+	}
+}
+
+bool SpillFile::IsOpen() const {
+	return file_ != nullptr;
+}
+
+std::uint64_t SpillFile::Size() const {
+	return size_;
+}
+
+std::uint64_t SpillFile::Extent() const {
+	return end_;
+}
+
+std::uint64_t SpillFile::Put(const std::vector<char>& bytes) {
+	if (!file_) {
+		return kNotStored;
+	}
+
+	Range range{Allocate(bytes.size()), bytes.size()};
+	if (!bytes.empty()) {
+		// Note: flushing reports write errors, e.g. a full disk, here
+		// instead of at a later seek.
+		if (!Seek(file_, range.offset) ||
+			std::fwrite(bytes.data(), 1, bytes.size(), file_) != bytes.size() ||
+			std::fflush(file_) != 0)
+		{
+			std::clearerr(file_);
+			Free(range);
+			return kNotStored;
+		}
+	}
+
+	size_ += range.size;
+	++live_;
+	if (!free_ids_.empty()) {
+		auto id = free_ids_.back();
+		free_ids_.pop_back();
+		extents_[id] = range;
+		return id;
+	}
+	extents_.push_back(range);
+	return extents_.size() - 1;
+}
+
+std::vector<char> SpillFile::Take(std::uint64_t id) {
+	auto& range = extents_[id];
+	std::vector<char> bytes(range.size);
+	if (!bytes.empty()) {
+		if (!Seek(file_, range.offset) ||
+			std::fread(bytes.data(), 1, bytes.size(), file_) != bytes.size())
+		{
+			std::clearerr(file_);
+			throw std::runtime_error("Cannot read spill file");
+		}
+	}
+
+	Drop(id);
+	return bytes;
+}
+
+void SpillFile::Drop(std::uint64_t id) {
+	size_ -= extents_[id].size;
+	Free(extents_[id]);
+	extents_[id].size = 0;
+	free_ids_.push_back(id);
+	if (--live_ == 0) {
+		extents_.clear();
+		free_ids_.clear();
+		free_.clear();
+		end_ = 0;
+	}
+}
+
+std::uint64_t SpillFile::Allocate(std::uint64_t size) {
+	if (size == 0) {
+		return end_;
+	}
+	for (auto it = free_.begin(); it != free_.end(); ++it) {
+		if (it->second < size) {
+			continue;
+		}
+		auto offset = it->first;
+		auto rest = it->second - size;
+		free_.erase(it);
+		if (rest > 0) {
+			free_.emplace(offset + size, rest);
+		}
+		return offset;
+	}
+
+	auto offset = end_;
+	end_ += size;
+	return offset;
+}
+
+void SpillFile::Free(Range range) {
+	if (range.size == 0) {
+		return;
+	}
+
+	auto next = free_.lower_bound(range.offset);
+	if (next != free_.end() && range.offset + range.size == next->first) {
+		range.size += next->second;
+		next = free_.erase(next);
+	}
+	if (next != free_.begin()) {
+		auto prev = std::prev(next);
+		if (prev->first + prev->second == range.offset) {
+			range.offset = prev->first;
+			range.size += prev->second;
+			free_.erase(prev);
+		}
+	}
+
+	if (range.offset + range.size == end_) {
+		end_ = range.offset;
+	} else {
+		free_.emplace(range.offset, range.size);
+	}
+}
+
+} // namespace undoable
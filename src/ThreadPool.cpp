@@ -0,0 +1,96 @@
+#include "undoable/ThreadPool.h"
+
+
+namespace undoable {
+
+ThreadPool::ThreadPool(std::size_t threads) {
+	// Note: the calling thread takes part in Run()
+	for (std::size_t i = 1; i < threads; ++i) {
+		threads_.emplace_back([this] { Work(); });
+	}
+}
+
+ThreadPool::~ThreadPool() {
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		stop_ = true;
+	}
+	wake_.notify_all();
+	for (auto& thread : threads_) {
+		thread.join();
+	}
+}
+
+std::size_t ThreadPool::Size() const {
+	return threads_.size() + 1;
+}
+
+void ThreadPool::Run(std::size_t count,
+	const std::function<void(std::size_t)>& task)
+{
+	if (count == 0) {
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		task_ = &task;
+		count_ = count;
+		next_ = 0;
+		remaining_ = count;
+		++generation_;
+	}
+	wake_.notify_all();
+
+	Process(task, count);
+
+	// Note: workers which picked up the task have to leave Process()
+	// before the counters can be reset by the next Run().
+	std::unique_lock<std::mutex> lock(mutex_);
+	done_.wait(lock, [this] { return remaining_ == 0 && active_ == 0; });
+	task_ = nullptr;
+}
+
+void ThreadPool::Work() {
+	std::unique_lock<std::mutex> lock(mutex_);
+	std::uint64_t seen = 0;
+
+	while (true) {
+		wake_.wait(lock, [&] { return stop_ || generation_ != seen; });
+		if (stop_) {
+			return;
+		}
+
+		seen = generation_;
+		if (!task_) {
+			continue;
+		}
+
+		auto* task = task_;
+		auto count = count_;
+		++active_;
+		lock.unlock();
+
+		Process(*task, count);
+
+		lock.lock();
+		if (--active_ == 0) {
+			done_.notify_all();
+		}
+	}
+}
+
+void ThreadPool::Process(const std::function<void(std::size_t)>& task,
+	std::size_t count)
+{
+	std::size_t index;
+	while ((index = next_.fetch_add(1)) < count) {
+		task(index);
+		if (remaining_.fetch_sub(1) == 1) {
+			std::lock_guard<std::mutex> lock(mutex_);
+			done_.notify_all();
+		}
+	}
+}
+
+} // namespace undoable
@@ -0,0 +1,84 @@
+#include "TestUtils.h"
+#include "undoable/Object.h"
+#include "undoable/Factory.h"
+#include "undoable/BufferProperty.h"
+
+using namespace undoable;
+
+namespace {
+
+class Document
+	: public Object
+{
+public:
+	virtual void OnPropertyChange(Property* property) override {
+		++handler_count;
+	}
+
+	TextProperty text{this};
+	BlobProperty data{this};
+	int handler_count = 0;
+};
+
+using Bytes = std::vector<std::uint8_t>;
+
+} // namespace
+
+TEST(BufferPropertyTest, Edits) {
+	Factory f;
+	auto& h = f.GetHistory();
+	auto& d = f.Create<Document>();
+
+	d.text.Set("hello world");
+	h.Commit();
+
+	d.text.Insert(5, ",");
+	d.text.Replace(7, 5, "there");
+	d.text.Append("!");
+	h.Commit();
+	EXPECT_EQ("hello, there!", d.text.Get());
+	EXPECT_EQ(4, d.handler_count);
+
+	d.text.Erase(0, 7);
+	h.Commit();
+	EXPECT_EQ("there!", d.text.Get());
+
+	h.Undo();
+	EXPECT_EQ("hello, there!", d.text.Get());
+
+	h.Undo();
+	EXPECT_EQ("hello world", d.text.Get());
+
+	h.Redo();
+	h.Redo();
+	EXPECT_EQ("there!", d.text.Get());
+
+	d.text.Replace(0, 5, "there");
+	EXPECT_FALSE(h.CanCommit());
+}
+
+TEST(BufferPropertyTest, SetDelta) {
+	Factory f;
+	auto& h = f.GetHistory();
+	auto& d = f.Create<Document>();
+
+	d.text.Set("abcdef");
+	h.Commit();
+
+	d.text.Set("abXYef");
+	d.text.Set("abXYef");
+	d.text.Set("abef");
+	d.text.Set("aabef");
+	h.Commit();
+	EXPECT_EQ("aabef", d.text.Get());
+
+	h.Undo();
+	EXPECT_EQ("abcdef", d.text.Get());
+
+	d.data.Set(Bytes({1, 2, 3}));
+	d.data.Erase(1, 1);
+	EXPECT_EQ(Bytes({1, 3}), d.data.Get());
+
+	h.Unstage();
+	EXPECT_TRUE(d.data.IsEmpty());
+}
@@ -0,0 +1,102 @@
+#include <thread>
+#include <vector>
+#include "TestUtils.h"
+#include "undoable/Object.h"
+#include "undoable/Factory.h"
+#include "undoable/Builder.h"
+#include "undoable/ValueProperty.h"
+#include "undoable/ListProperty.h"
+
+using namespace undoable;
+
+namespace {
+
+int& Created() {
+	static int created = 0;
+	return created;
+}
+
+class Element
+	: public Object
+	, public ListNode<Element, struct tag_children>
+{
+public:
+	ValueProperty<int> value{this};
+	ListProperty<Element, struct tag_children> children{this};
+
+	virtual void OnCreate() override { ++Created(); }
+	virtual void OnDestroy() override { --Created(); }
+};
+
+} // namespace
+
+TEST(BuilderTest, Attach) {
+	Created() = 0;
+	Factory f;
+	auto& h = f.GetHistory();
+	auto& root = f.Create<Element>();
+	h.Commit();
+
+	Builder builder;
+	Element* first = nullptr;
+	std::thread worker([&] {
+		auto& parent = builder.Create<Element>();
+		parent.value.Set(-1);
+		for (int i = 0; i < 100; ++i) {
+			auto& child = builder.Create<Element>();
+			child.value.Set(i);
+			parent.children.LinkBack(child);
+		}
+		first = &parent;
+	});
+	worker.join();
+
+	EXPECT_EQ(101, builder.Size());
+	EXPECT_EQ(1, Created());
+	EXPECT_EQ(100, first->children.Size());
+
+	f.Attach(builder);
+	EXPECT_TRUE(builder.IsEmpty());
+	EXPECT_TRUE(first->IsCreated());
+	EXPECT_EQ(102, Created());
+	h.Commit();
+
+	int count = 0;
+	f.ForEachObject([&](Object*) { ++count; });
+	EXPECT_EQ(102, count);
+
+	// Attached objects are regular objects
+	first->value.Set(5);
+	root.children.LinkBack(*first);
+	h.Commit();
+	h.Undo();
+	EXPECT_EQ(-1, first->value.Get());
+
+	h.Undo();
+	EXPECT_TRUE(first->IsDestroyed());
+	EXPECT_EQ(1, Created());
+
+	h.Redo();
+	EXPECT_TRUE(first->IsCreated());
+	EXPECT_EQ(102, Created());
+	EXPECT_EQ(100, first->children.Size());
+
+	h.Undo();
+	h.Clear();
+	count = 0;
+	f.ForEachObject([&](Object*) { ++count; });
+	EXPECT_EQ(1, count);
+}
+
+TEST(BuilderTest, Discard) {
+	Created() = 0;
+	Builder builder;
+	auto& parent = builder.Create<Element>();
+	parent.children.LinkBack(builder.Create<Element>());
+	EXPECT_EQ(0, Created());
+
+	Factory f;
+	Builder empty;
+	f.Attach(empty);
+	EXPECT_FALSE(f.GetHistory().CanCommit());
+}
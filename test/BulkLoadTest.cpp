@@ -0,0 +1,165 @@
+#include <vector>
+#include "TestUtils.h"
+#include "undoable/Object.h"
+#include "undoable/Factory.h"
+#include "undoable/ValueProperty.h"
+#include "undoable/ListProperty.h"
+
+using namespace undoable;
+
+namespace {
+
+std::vector<Object*>& CreateOrder() {
+	static std::vector<Object*> order;
+	return order;
+}
+
+class Element
+	: public Object
+	, public ListNode<Element, struct tag_children>
+{
+public:
+	ValueProperty<int> value{this};
+	ListProperty<Element, struct tag_children> children{this};
+
+	virtual ~Element() { ++Deleted(); }
+	virtual void OnCreate() override { CreateOrder().push_back(this); }
+
+	static int& Deleted() {
+		static int deleted = 0;
+		return deleted;
+	}
+};
+
+class Counter : public ChangeListener {
+public:
+	virtual void OnChanges(const ChangeSet& changes) override {
+		++calls;
+		created += changes.created.size();
+	}
+
+	int calls = 0;
+	std::size_t created = 0;
+};
+
+class DestroyChecker : public ChangeListener {
+public:
+	virtual void OnChanges(const ChangeSet& changes) override {
+		deleted = Element::Deleted();
+		for (auto* object : changes.destroyed) {
+			destroyed += object->IsDestroyed();
+		}
+	}
+
+	int deleted = -1;
+	int destroyed = 0;
+};
+
+} // namespace
+
+TEST(BulkLoadTest, InPlace) {
+	CreateOrder().clear();
+	Factory f;
+	auto& h = f.GetHistory();
+	Counter counter;
+	h.AddListener(&counter);
+
+	auto& e0 = f.Create<Element>();
+	e0.value.Set(3);
+	h.Commit();
+
+	Element* e1;
+	{
+		Factory::BulkLoad load(f);
+		EXPECT_TRUE(h.IsBulkLoading());
+		EXPECT_FALSE(h.CanUndo());
+		EXPECT_EQ(3, e0.value.Get());
+
+		e1 = &f.Create<Element>();
+		EXPECT_TRUE(e1->IsCreated());
+		EXPECT_EQ(2, CreateOrder().size());
+
+		e1->value.Set(1);
+		e0.children.LinkBack(*e1);
+		EXPECT_EQ(1, e1->value.Get());
+		EXPECT_FALSE(h.CanCommit());
+
+		f.Create<Element>().Destroy();
+		EXPECT_EQ(1, counter.calls);
+	}
+
+	EXPECT_FALSE(h.IsBulkLoading());
+	EXPECT_FALSE(h.CanCommit());
+	EXPECT_FALSE(h.CanUndo());
+	EXPECT_EQ(2, counter.calls);
+	EXPECT_EQ(2, counter.created);
+	EXPECT_EQ(1, e0.children.Size());
+
+	int count = 0;
+	f.ForEachObject([&](Object*) { ++count; });
+	EXPECT_EQ(2, count);
+
+	// Regular editing afterwards
+	e1->value.Set(2);
+	h.Commit();
+	h.Undo();
+	EXPECT_EQ(1, e1->value.Get());
+	h.RemoveListener(&counter);
+}
+
+TEST(BulkLoadTest, DeferOnCreate) {
+	CreateOrder().clear();
+	Factory f;
+	std::vector<Element*> elements;
+	{
+		Factory::BulkLoad load(f, true);
+		for (int i = 0; i < 10; ++i) {
+			auto& e = f.Create<Element>();
+			e.value.Set(i);
+			if (!elements.empty()) {
+				elements.front()->children.LinkBack(e);
+			}
+			elements.push_back(&e);
+		}
+		EXPECT_TRUE(CreateOrder().empty());
+		EXPECT_FALSE(elements[0]->IsCreated());
+	}
+
+	EXPECT_EQ(10, CreateOrder().size());
+	for (int i = 0; i < 10; ++i) {
+		EXPECT_EQ(elements[i], CreateOrder()[i]);
+		EXPECT_TRUE(elements[i]->IsCreated());
+		EXPECT_EQ(i, elements[i]->value.Get());
+	}
+	EXPECT_EQ(9, elements[0]->children.Size());
+	EXPECT_FALSE(f.GetHistory().CanCommit());
+
+	elements[1]->Destroy();
+	f.GetHistory().Commit();
+	EXPECT_EQ(8, elements[0]->children.Size());
+}
+
+TEST(BulkLoadTest, DestroyAfterDelivery) {
+	Factory f;
+	auto& h = f.GetHistory();
+	auto& e0 = f.Create<Element>();
+	auto& e1 = f.Create<Element>();
+	auto& e2 = f.Create<Element>();
+	h.Commit();
+
+	DestroyChecker checker;
+	h.AddListener(&checker);
+	Element::Deleted() = 0;
+	{
+		Factory::BulkLoad load(f);
+		e0.Destroy();
+		std::vector<Element*> many{&e1, &e2};
+		f.DestroyMany(many);
+		EXPECT_EQ(0, Element::Deleted());
+	}
+
+	EXPECT_EQ(0, checker.deleted);
+	EXPECT_EQ(3, checker.destroyed);
+	EXPECT_EQ(3, Element::Deleted());
+	h.RemoveListener(&checker);
+}
@@ -0,0 +1,103 @@
+#include "TestUtils.h"
+#include "undoable/Object.h"
+#include "undoable/Factory.h"
+#include "undoable/ValueProperty.h"
+#include "undoable/ListProperty.h"
+#include <vector>
+
+using namespace undoable;
+
+namespace {
+
+class Element
+	: public Object
+	, public ListNode<Element, struct tag_children>
+{
+public:
+	ValueProperty<int> value{this};
+	ListProperty<Element, struct tag_children> children{this};
+};
+
+class Recorder
+	: public ChangeListener
+{
+public:
+	virtual void OnChanges(const ChangeSet& changes) override {
+		sets.push_back(changes);
+	}
+
+	std::vector<ChangeSet> sets;
+};
+
+using Objects = std::vector<Object*>;
+using Properties = std::vector<Property*>;
+
+} // namespace
+
+TEST(ChangeSetTest, CommitUndoRedo) {
+	Factory f;
+	auto& h = f.GetHistory();
+	Recorder r;
+	h.AddListener(&r);
+
+	auto& e1 = f.Create<Element>();
+	auto& e2 = f.Create<Element>();
+	e1.value.Set(3);
+	e1.value.Set(4);
+	e1.children.LinkBack(e2);
+	h.Commit();
+
+	EXPECT_EQ(1, r.sets.size());
+	EXPECT_EQ(Objects({&e1, &e2}), r.sets[0].created);
+	EXPECT_TRUE(r.sets[0].destroyed.empty());
+	EXPECT_EQ(Properties({&e1.value, &e1.children}), r.sets[0].modified);
+
+	e2.Destroy();
+	h.Commit();
+	EXPECT_EQ(2, r.sets.size());
+	EXPECT_EQ(Objects({&e2}), r.sets[1].destroyed);
+	EXPECT_EQ(Properties({&e1.children}), r.sets[1].modified);
+
+	h.Undo();
+	EXPECT_EQ(3, r.sets.size());
+	EXPECT_EQ(Objects({&e2}), r.sets[2].created);
+
+	h.Redo();
+	EXPECT_EQ(4, r.sets.size());
+	EXPECT_EQ(Objects({&e2}), r.sets[3].destroyed);
+
+	h.Undo();
+	h.Undo();
+	h.Undo();
+	EXPECT_EQ(6, r.sets.size());
+	EXPECT_EQ(Objects({&e2, &e1}), r.sets[5].destroyed);
+
+	h.RemoveListener(&r);
+	h.Redo();
+	EXPECT_EQ(6, r.sets.size());
+}
+
+TEST(ChangeSetTest, Unstage) {
+	Factory f;
+	auto& h = f.GetHistory();
+	Recorder r;
+	h.AddListener(&r);
+
+	auto& e1 = f.Create<Element>();
+	h.Commit();
+
+	auto& e2 = f.Create<Element>();
+	e2.value.Set(5);
+	e1.value.Set(6);
+	h.Unstage();
+
+	EXPECT_EQ(2, r.sets.size());
+	EXPECT_TRUE(r.sets[1].created.empty());
+	EXPECT_TRUE(r.sets[1].destroyed.empty());
+	EXPECT_EQ(Properties({&e1.value}), r.sets[1].modified);
+
+	h.Unstage();
+	h.Commit();
+	EXPECT_EQ(2, r.sets.size());
+	h.RemoveListener(&r);
+}
@@ -0,0 +1,68 @@
+#include "TestUtils.h"
+#include "undoable/Factory.h"
+#include "undoable/ColumnTable.h"
+#include <numeric>
+#include <string>
+
+using namespace undoable;
+
+namespace {
+
+class Shapes
+	: public ColumnTable
+{
+public:
+	Column<int> x{this};
+	Column<int> y{this};
+	Column<std::string> name{this};
+};
+
+using Ints = std::vector<int>;
+
+Ints ToVector(const Column<int>& column) {
+	return Ints(column.begin(), column.end());
+}
+
+} // namespace
+
+TEST(ColumnTableTest, Rows) {
+	Factory f;
+	auto& h = f.GetHistory();
+	auto& s = f.Create<Shapes>();
+
+	EXPECT_EQ(0, s.Size());
+	EXPECT_EQ(0, s.AddRows(3));
+	EXPECT_EQ(3, s.AddRows(2));
+	EXPECT_EQ(5, s.Size());
+	EXPECT_EQ(5, s.name.Size());
+	h.Commit();
+
+	for (int i = 0; i < 5; ++i) {
+		s.x.Set(i, i + 1);
+	}
+	s.name.Set(2, "two");
+	h.Commit();
+	EXPECT_EQ(15, std::accumulate(s.x.begin(), s.x.end(), 0));
+	EXPECT_EQ(3, s.x.Data()[2]);
+
+	s.Resize(2);
+	h.Commit();
+	EXPECT_EQ(Ints({1, 2}), ToVector(s.x));
+
+	h.Undo();
+	EXPECT_EQ(Ints({1, 2, 3, 4, 5}), ToVector(s.x));
+	EXPECT_EQ("two", s.name[2]);
+
+	h.Undo();
+	EXPECT_EQ(Ints({0, 0, 0, 0, 0}), ToVector(s.x));
+	EXPECT_EQ("", s.name[2]);
+
+	h.Undo();
+	EXPECT_EQ(0, s.Size());
+
+	h.Redo();
+	h.Redo();
+	h.Redo();
+	EXPECT_EQ(Ints({1, 2}), ToVector(s.x));
+	EXPECT_EQ(2, s.name.Size());
+}
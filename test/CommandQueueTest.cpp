@@ -0,0 +1,93 @@
+#include "TestUtils.h"
+#include "undoable/Object.h"
+#include "undoable/Factory.h"
+#include "undoable/ValueProperty.h"
+#include "undoable/CommandQueue.h"
+#include <thread>
+#include <vector>
+
+using namespace undoable;
+
+namespace {
+
+class Counter
+	: public Object
+{
+public:
+	ValueProperty<int> value{this};
+};
+
+class Increment : public Command {
+public:
+	Increment(int& value) : value_(value) {}
+
+	virtual void Apply(bool reverse) override {
+		value_ += reverse ? -1 : 1;
+	}
+
+private:
+	int& value_;
+};
+
+} // namespace
+
+TEST(CommandQueueTest, Drain) {
+	Factory f;
+	auto& h = f.GetHistory();
+	auto& c = f.Create<Counter>();
+	h.Commit();
+
+	CommandQueue q;
+	int count = 0;
+
+	for (int i = 1; i <= 3; ++i) {
+		CommandQueue::Batch batch;
+		batch.Add([&c, i]() { c.value.Set(i); });
+		batch.Add(MakeUnique<Increment>(count));
+		q.Submit(std::move(batch));
+	}
+
+	c.value.Set(10);
+	EXPECT_EQ(0, q.Drain(h));
+	h.Unstage();
+
+	EXPECT_EQ(2, q.Drain(h, 2));
+	EXPECT_EQ(2, c.value.Get());
+	EXPECT_EQ(2, count);
+
+	EXPECT_EQ(1, q.Drain(h));
+	EXPECT_EQ(3, c.value.Get());
+	EXPECT_EQ(0, q.Drain(h));
+
+	h.Undo();
+	EXPECT_EQ(2, c.value.Get());
+	EXPECT_EQ(2, count);
+}
+
+TEST(CommandQueueTest, Producers) {
+	History h;
+	CommandQueue q;
+	int count = 0;
+	std::vector<std::thread> producers;
+
+	for (int i = 0; i < 4; ++i) {
+		producers.emplace_back([&q, &count]() {
+			for (int k = 0; k < 250; ++k) {
+				CommandQueue::Batch batch;
+				batch.Add(MakeUnique<Increment>(count));
+				q.Submit(std::move(batch));
+			}
+		});
+	}
+
+	std::size_t drained = 0;
+	while (drained < 1000) {
+		drained += q.Drain(h);
+	}
+	for (auto& producer : producers) {
+		producer.join();
+	}
+
+	EXPECT_EQ(1000, count);
+	EXPECT_EQ(0, q.Drain(h));
+}
@@ -0,0 +1,116 @@
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "TestUtils.h"
+#include "undoable/Object.h"
+#include "undoable/Factory.h"
+#include "undoable/CompressedStore.h"
+#include "undoable/BufferProperty.h"
+
+using namespace undoable;
+
+namespace {
+
+class Document
+	: public Object
+{
+public:
+	TextProperty text{this};
+};
+
+std::vector<char> Bytes(const std::string& str) {
+	return std::vector<char>(str.begin(), str.end());
+}
+
+} // namespace
+
+TEST(CompressedStoreTest, RoundTrip) {
+	std::vector<std::vector<char>> inputs{
+		{},
+		Bytes("a"),
+		Bytes("abcd"),
+		Bytes("abcabcabcabcabcabcabcabcx"),
+		Bytes(std::string(10000, 'z')),
+	};
+
+	std::vector<char> noise;
+	unsigned state = 1;
+	for (int i = 0; i < 5000; ++i) {
+		state = state * 1103515245 + 12345;
+		noise.push_back(static_cast<char>(state >> 16));
+	}
+	inputs.push_back(noise);
+
+	for (auto& input : inputs) {
+		auto compressed = CompressedStore::Compress(input);
+		EXPECT_TRUE((input == CompressedStore::Decompress(compressed, input.size())));
+	}
+
+	auto compressed = CompressedStore::Compress(inputs[4]);
+	EXPECT_TRUE((compressed.size() < 100));
+
+	CompressedStore store;
+	auto id0 = store.Put(inputs[3]);
+	auto id1 = store.Put(inputs[4]);
+	EXPECT_EQ(10025, store.RawSize());
+	EXPECT_TRUE((inputs[4] == store.Take(id1)));
+	store.Drop(id0);
+	EXPECT_EQ(0, store.Size());
+	EXPECT_EQ(0, store.RawSize());
+}
+
+TEST(CompressedStoreTest, Corrupted) {
+	std::vector<char> input(1000, 'a');
+	for (std::size_t i = 0; i < input.size(); i += 7) {
+		input[i] = static_cast<char>('a' + i % 13);
+	}
+	auto compressed = CompressedStore::Compress(input);
+
+	std::vector<std::vector<char>> corrupted;
+	corrupted.push_back({});
+	corrupted.push_back(std::vector<char>(compressed.begin(),
+		compressed.begin() + compressed.size() / 2));
+	corrupted.push_back({'\x7f', 'a'});
+	corrupted.push_back({'\x01', 'a', '\x00', '\x05'});
+	corrupted.push_back(std::vector<char>(12, '\xff'));
+	for (std::size_t i = 0; i < compressed.size(); i += 5) {
+		auto bytes = compressed;
+		bytes[i] = static_cast<char>(bytes[i] ^ 0x5a);
+		corrupted.push_back(bytes);
+	}
+
+	for (auto& bytes : corrupted) {
+		try {
+			auto out = CompressedStore::Decompress(bytes, input.size());
+			EXPECT_EQ(input.size(), out.size());
+		} catch (const std::runtime_error&) {
+		}
+	}
+}
+
+TEST(CompressedStoreTest, ColdTier) {
+	CompressedStore store;
+	Factory f;
+	auto& h = f.GetHistory();
+	auto& doc = f.Create<Document>();
+	h.Commit();
+	h.SetSpillStore(&store, 1);
+
+	std::string text;
+	for (int i = 0; i < 20; ++i) {
+		text = std::string(1000 + i, static_cast<char>('a' + i));
+		doc.text.Set(text);
+		h.Commit();
+	}
+	EXPECT_TRUE((store.RawSize() > 18000));
+	EXPECT_TRUE((store.Size() * 10 < store.RawSize()));
+
+	for (int i = 18; i >= 0; --i) {
+		h.Undo();
+		EXPECT_EQ(std::string(1000 + i, static_cast<char>('a' + i)),
+			doc.text.Get());
+	}
+	h.Undo();
+	EXPECT_EQ("", doc.text.Get());
+	EXPECT_EQ(0, store.RawSize());
+}
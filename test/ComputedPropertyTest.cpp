@@ -0,0 +1,113 @@
+#include "TestUtils.h"
+#include "undoable/Object.h"
+#include "undoable/Factory.h"
+#include "undoable/Fragment.h"
+#include "undoable/ValueProperty.h"
+#include "undoable/ComputedProperty.h"
+
+using namespace undoable;
+
+namespace {
+
+class Size
+	: public Fragment
+{
+public:
+	using Fragment::Fragment;
+	ValueProperty<int> w{this, 1};
+	ValueProperty<int> h{this, 1};
+};
+
+class Rect
+	: public Object
+{
+public:
+	using Dependencies = ComputedPropertyBase::Dependencies;
+
+	ValueProperty<int> x{this};
+	Size size{this};
+	ValueProperty<int> label{this};
+
+	ComputedProperty<int> area{this, [this](Dependencies& read) {
+		++area_count;
+		read(size);
+		return size.w.Get() * size.h.Get();
+	}};
+
+	ComputedProperty<int> right{this, [this](Dependencies& read) {
+		++right_count;
+		return read(x).Get() + read(area).Get();
+	}};
+
+	int area_count = 0;
+	int right_count = 0;
+};
+
+} // namespace
+
+TEST(ComputedPropertyTest, Lazy) {
+	Factory f;
+	auto& h = f.GetHistory();
+	auto& r = f.Create<Rect>();
+
+	EXPECT_FALSE(r.area.IsValid());
+	EXPECT_EQ(1, r.right.Get());
+	EXPECT_EQ(1, r.area_count);
+	EXPECT_EQ(1, r.right_count);
+
+	r.size.w.Set(2);
+	r.size.w.Set(3);
+	r.size.h.Set(4);
+	EXPECT_FALSE(r.area.IsValid());
+	EXPECT_FALSE(r.right.IsValid());
+	EXPECT_EQ(12, r.area.Get());
+	EXPECT_EQ(2, r.area_count);
+	h.Commit();
+
+	r.label.Set(5);
+	r.x.Set(1);
+	EXPECT_TRUE(r.area.IsValid());
+	EXPECT_EQ(13, r.right.Get());
+	EXPECT_EQ(13, r.right.Get());
+	EXPECT_EQ(2, r.area_count);
+	EXPECT_EQ(2, r.right_count);
+	h.Commit();
+
+	h.Undo();
+	h.Undo();
+	h.Redo();
+	EXPECT_EQ(12, r.right.Get());
+	EXPECT_EQ(3, r.area_count);
+	EXPECT_EQ(3, r.right_count);
+}
+
+TEST(ComputedPropertyTest, FragmentProperty) {
+	class Box
+		: public Object
+	{
+	public:
+		using Dependencies = ComputedPropertyBase::Dependencies;
+
+		Size size{this};
+		ComputedProperty<int> width{this, [this](Dependencies& read) {
+			return read(size.w).Get() * 10;
+		}};
+	};
+
+	Factory f;
+	auto& h = f.GetHistory();
+	auto& b = f.Create<Box>();
+	h.Commit();
+
+	EXPECT_EQ(10, b.width.Get());
+	b.size.w.Set(2);
+	EXPECT_FALSE(b.width.IsValid());
+	EXPECT_EQ(20, b.width.Get());
+
+	b.size.h.Set(3);
+	EXPECT_FALSE(b.width.IsValid());
+	h.Commit();
+
+	h.Undo();
+	EXPECT_EQ(10, b.width.Get());
+}
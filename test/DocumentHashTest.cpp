@@ -0,0 +1,239 @@
+#include "TestUtils.h"
+#include "undoable/Object.h"
+#include "undoable/Factory.h"
+#include "undoable/DocumentHash.h"
+#include "undoable/Fragment.h"
+#include "undoable/ValueProperty.h"
+#include "undoable/ListProperty.h"
+#include "undoable/RefProperty.h"
+#include <map>
+#include <string>
+
+using namespace undoable;
+
+namespace {
+
+class Element
+	: public Object
+	, public ListNode<Element, struct tag_children>
+{
+public:
+	ValueProperty<int> value{this};
+	ValueProperty<std::string> name{this};
+	RefProperty<Element> target{this};
+	ListProperty<Element, struct tag_children> children{this};
+};
+
+struct Extent {
+	std::int32_t width;
+	std::int32_t height;
+};
+
+bool operator!=(const Extent& lhs, const Extent& rhs) {
+	return lhs.width != rhs.width || lhs.height != rhs.height;
+}
+
+class Frame
+	: public Object
+{
+public:
+	ValueProperty<Extent> extent{this, Extent{0, 0}};
+};
+
+struct Label {
+	std::string text;
+};
+
+bool operator!=(const Label& lhs, const Label& rhs) {
+	return lhs.text != rhs.text;
+}
+
+int& HashCalls() {
+	static int calls = 0;
+	return calls;
+}
+
+class CountedProperty
+	: public ValueProperty<int>
+{
+public:
+	using ValueProperty<int>::ValueProperty;
+
+	virtual std::uint64_t Hash() const override {
+		++HashCalls();
+		return ValueProperty<int>::Hash();
+	}
+};
+
+class Size
+	: public Fragment
+{
+public:
+	using Fragment::Fragment;
+	ValueProperty<int> w{this};
+	ValueProperty<int> h{this};
+};
+
+class Box
+	: public Object
+{
+public:
+	CountedProperty counted{this};
+	ValueProperty<int> value{this};
+	Size size{this};
+};
+
+class Settings
+	: public Object
+{
+public:
+	ValueProperty<std::map<std::string, int>> values{this};
+	ValueProperty<Label> label{this};
+};
+
+} // namespace
+
+TEST(DocumentHashTest, UndoRedo) {
+	Factory f;
+	auto& h = f.GetHistory();
+	DocumentHash hash(f);
+	auto empty = hash.Get();
+
+	auto& e1 = f.Create<Element>();
+	auto& e2 = f.Create<Element>();
+	e1.name.Set("e1");
+	h.Commit();
+	auto saved = hash.Get();
+	EXPECT_TRUE(saved != empty);
+
+	e1.value.Set(3);
+	h.Commit();
+	EXPECT_TRUE(saved != hash.Get());
+
+	e1.target.Set(&e2);
+	e1.children.LinkBack(e2);
+	h.Commit();
+	auto linked = hash.Get();
+
+	e2.Destroy();
+	h.Commit();
+	EXPECT_TRUE(linked != hash.Get());
+
+	h.Undo();
+	EXPECT_EQ(linked, hash.Get());
+
+	h.Undo();
+	h.Undo();
+	EXPECT_EQ(saved, hash.Get());
+
+	DocumentHash rescan(f);
+	EXPECT_EQ(saved, rescan.Get());
+
+	h.Redo();
+	h.Redo();
+	h.Redo();
+	EXPECT_EQ(hash.Get(), rescan.Get());
+
+	h.Undo();
+	h.Undo();
+	h.Undo();
+	h.Undo();
+	EXPECT_EQ(empty, hash.Get());
+}
+
+TEST(DocumentHashTest, Order) {
+	Factory f;
+	auto& h = f.GetHistory();
+	DocumentHash hash(f);
+
+	auto& e1 = f.Create<Element>();
+	h.Commit();
+	auto initial = hash.Get();
+
+	e1.value.Set(1);
+	e1.name.Set("x");
+	h.Commit();
+	auto changed = hash.Get();
+
+	e1.value.Set(0);
+	e1.name.Set("");
+	h.Commit();
+	EXPECT_EQ(initial, hash.Get());
+
+	e1.name.Set("x");
+	e1.value.Set(1);
+	h.Commit();
+	EXPECT_EQ(changed, hash.Get());
+}
+
+TEST(DocumentHashTest, TriviallyCopyable) {
+	Factory f;
+	auto& h = f.GetHistory();
+	DocumentHash hash(f);
+
+	auto& frame = f.Create<Frame>();
+	h.Commit();
+	auto initial = hash.Get();
+
+	frame.extent.Set(Extent{4, 3});
+	h.Commit();
+	EXPECT_TRUE(initial != hash.Get());
+
+	h.Undo();
+	EXPECT_EQ(initial, hash.Get());
+}
+
+TEST(DocumentHashTest, Unhashable) {
+	static_assert(IsHashable<std::map<std::string, int>>::value, "");
+	static_assert(!IsHashable<Label>::value, "");
+
+	Factory f;
+	auto& h = f.GetHistory();
+	DocumentHash hash(f);
+
+	auto& settings = f.Create<Settings>();
+	h.Commit();
+	auto initial = hash.Get();
+
+	settings.values.Set({{"a", 1}});
+	h.Commit();
+	auto changed = hash.Get();
+	EXPECT_TRUE(initial != changed);
+
+	// Values without HashValue() do not contribute
+	settings.label.Set(Label{"x"});
+	h.Commit();
+	EXPECT_EQ(changed, hash.Get());
+}
+
+TEST(DocumentHashTest, ModifiedProperties) {
+	Factory f;
+	auto& h = f.GetHistory();
+	DocumentHash hash(f);
+
+	auto& box = f.Create<Box>();
+	h.Commit();
+	HashCalls() = 0;
+
+	// Only modified properties are hashed again
+	box.value.Set(1);
+	box.size.w.Set(2);
+	h.Commit();
+	EXPECT_EQ(0, HashCalls());
+	EXPECT_EQ(DocumentHash(f).Get(), hash.Get());
+
+	HashCalls() = 0;
+	box.counted.Set(3);
+	h.Commit();
+	EXPECT_EQ(1, HashCalls());
+
+	box.size.h.Set(4);
+	h.Commit();
+	EXPECT_EQ(DocumentHash(f).Get(), hash.Get());
+
+	h.Undo();
+	h.Undo();
+	h.Undo();
+	EXPECT_EQ(DocumentHash(f).Get(), hash.Get());
+	EXPECT_EQ(hash.GetObjectHash(&box), DocumentHash(f).GetObjectHash(&box));
+}
@@ -0,0 +1,217 @@
+#include <vector>
+#include "TestUtils.h"
+#include "undoable/Object.h"
+#include "undoable/Factory.h"
+#include "undoable/ValueProperty.h"
+#include "undoable/ListProperty.h"
+#include "undoable/OwningListProperty.h"
+#include "undoable/RefProperty.h"
+
+using namespace undoable;
+
+namespace {
+
+int& Alive() {
+	static int alive = 0;
+	return alive;
+}
+
+class Element
+	: public Object
+	, public ListNode<Element, struct tag_children>
+{
+public:
+	ValueProperty<int> value{this};
+	ListProperty<Element, struct tag_children> children{this};
+	RefProperty<Element> next{this};
+
+	virtual void OnCreate() override { ++Alive(); }
+	virtual void OnDestroy() override { --Alive(); }
+};
+
+class Owner
+	: public Object
+{
+public:
+	OwningListProperty<Element, struct tag_children> elements{this};
+};
+
+int CountObjects(Factory& f) {
+	int count = 0;
+	f.ForEachObject([&](Object*) { ++count; });
+	return count;
+}
+
+} // namespace
+
+TEST(FactoryTest, CreateMany) {
+	Alive() = 0;
+	Factory f;
+	auto& h = f.GetHistory();
+	auto& root = f.Create<Element>();
+	h.Commit();
+
+	auto elements = f.CreateMany<Element>(100, [&](Element& e, std::size_t i) {
+		e.value.Set(static_cast<int>(i));
+	});
+	EXPECT_EQ(100, elements.size());
+	EXPECT_EQ(101, Alive());
+	EXPECT_EQ(101, CountObjects(f));
+	for (int i = 0; i < 100; ++i) {
+		EXPECT_TRUE(elements[i]->IsCreated());
+		EXPECT_EQ(i, elements[i]->value.Get());
+		root.children.LinkBack(*elements[i]);
+	}
+	h.Commit();
+	EXPECT_EQ(100, root.children.Size());
+
+	h.Undo();
+	EXPECT_EQ(1, Alive());
+	EXPECT_TRUE(elements[0]->IsDestroyed());
+	EXPECT_EQ(0, root.children.Size());
+
+	h.Redo();
+	EXPECT_EQ(101, Alive());
+	EXPECT_EQ(100, root.children.Size());
+	EXPECT_EQ(99, root.children.Back().value.Get());
+
+	h.Undo();
+	h.Clear();
+	EXPECT_EQ(1, CountObjects(f));
+
+	EXPECT_TRUE(f.CreateMany<Element>(0, [](Element&, std::size_t) {}).empty());
+	EXPECT_FALSE(h.CanCommit());
+}
+
+TEST(FactoryTest, CreateManyLinksExisting) {
+	Alive() = 0;
+	Factory f;
+	auto& h = f.GetHistory();
+	auto& root = f.Create<Element>();
+	h.Commit();
+
+	auto elements = f.CreateMany<Element>(10, [&](Element& e, std::size_t) {
+		e.next.Set(&root);
+		root.children.LinkBack(e);
+	});
+	h.Commit();
+	EXPECT_EQ(10, root.children.Size());
+	EXPECT_EQ(&root, &*elements[9]->next);
+
+	// Changes of `init` are undone with the creation
+	h.Undo();
+	EXPECT_EQ(1, Alive());
+	EXPECT_EQ(0, root.children.Size());
+	EXPECT_FALSE(elements[9]->next);
+
+	h.Redo();
+	EXPECT_EQ(11, Alive());
+	EXPECT_EQ(10, root.children.Size());
+	EXPECT_EQ(&root, &*elements[0]->next);
+
+	root.Destroy();
+	h.Commit();
+	EXPECT_FALSE(elements[0]->next);
+	h.Undo();
+	EXPECT_EQ(&root, &*elements[0]->next);
+}
+
+TEST(FactoryTest, DestroyMany) {
+	Alive() = 0;
+	Factory f;
+	auto& h = f.GetHistory();
+	auto& root = f.Create<Element>();
+	auto elements = f.CreateMany<Element>(100, [](Element&, std::size_t) {});
+	for (std::size_t i = 0; i < elements.size(); ++i) {
+		root.children.LinkBack(*elements[i]);
+		root.next.Set(elements[i]);
+		if (i > 0) {
+			elements[i - 1]->next.Set(elements[i]);
+			elements[i - 1]->children.LinkBack(f.Create<Element>());
+		}
+	}
+	h.Commit();
+	EXPECT_EQ(200, Alive());
+
+	// Duplicates and destroyed objects are ignored
+	auto selection = elements;
+	selection.push_back(elements.front());
+	f.DestroyMany(selection);
+	EXPECT_EQ(100, Alive());
+	EXPECT_TRUE(elements[50]->IsDestroyed());
+	EXPECT_EQ(0, root.children.Size());
+	EXPECT_FALSE(root.next);
+	EXPECT_EQ(0, elements[0]->children.Size());
+	f.DestroyMany(selection);
+	h.Commit();
+
+	h.Undo();
+	EXPECT_EQ(200, Alive());
+	EXPECT_EQ(100, root.children.Size());
+	EXPECT_EQ(elements.back(), &*root.next);
+	EXPECT_EQ(elements[1], &*elements[0]->next);
+	EXPECT_EQ(1, elements[0]->children.Size());
+
+	h.Redo();
+	EXPECT_EQ(100, Alive());
+	h.Undo();
+	EXPECT_EQ(200, Alive());
+}
+
+TEST(FactoryTest, DestroyManyOwning) {
+	Alive() = 0;
+	Factory f;
+	auto& h = f.GetHistory();
+	auto& owner = f.Create<Owner>();
+	auto elements = f.CreateMany<Element>(10, [&](Element& e, std::size_t) {
+		owner.elements.LinkBack(e);
+	});
+	h.Commit();
+	EXPECT_EQ(10, owner.elements.Size());
+
+	elements[0]->next.Set(elements[5]);
+	h.Commit();
+
+	std::vector<Object*> selection{&owner, elements[0], elements[5]};
+	f.DestroyMany(selection);
+	EXPECT_TRUE(owner.IsDestroyed());
+	EXPECT_EQ(0, Alive());
+	h.Commit();
+
+	h.Undo();
+	EXPECT_TRUE(owner.IsCreated());
+	EXPECT_EQ(10, Alive());
+	EXPECT_EQ(10, owner.elements.Size());
+
+	h.Redo();
+	EXPECT_TRUE(owner.IsDestroyed());
+	EXPECT_EQ(0, Alive());
+	h.Undo();
+	EXPECT_EQ(10, owner.elements.Size());
+	EXPECT_EQ(elements[5], &*elements[0]->next);
+}
+
+TEST(FactoryTest, DeferredReclaim) {
+	Factory f;
+	auto& h = f.GetHistory();
+	h.SetDeferredReclaim(true);
+
+	auto& root = f.Create<Element>();
+	h.Commit();
+	f.CreateMany<Element>(10, [](Element&, std::size_t) {});
+	h.Commit();
+	h.Undo();
+
+	root.value.Set(1);
+	h.Commit();
+	EXPECT_EQ(11, CountObjects(f));
+
+	h.Reclaim(std::chrono::seconds(1));
+	EXPECT_EQ(1, CountObjects(f));
+
+	// Queued objects are deleted by the Factory
+	f.Create<Element>();
+	h.Commit();
+	h.Undo();
+	h.Clear();
+}
@@ -218,3 +218,99 @@ TEST(HistoryTest, Clear) {
 	EXPECT_EQ(Events({{3, kChange}, {3, kRevert}, {3, kDeleted}}), ev);
 	EXPECT_FALSE(h.CanRedo());
 }
+
+TEST(HistoryTest, DeferredReclaim) {
+	Events ev;
+	History h;
+	h.SetDeferredReclaim(true);
+
+	h.Stage(MakeUnique<Tick>(1, ev));
+	h.Stage(MakeUnique<Tick>(2, ev));
+	h.Commit();
+	h.Undo();
+	ev.clear();
+
+	h.Stage(MakeUnique<Tick>(3, ev));
+	h.Commit();
+	EXPECT_EQ(Events({{3, kChange}}), ev);
+	EXPECT_FALSE(h.CanRedo());
+
+	EXPECT_TRUE(h.Reclaim(std::chrono::milliseconds(100)));
+	EXPECT_EQ(Events({{3, kChange}, {2, kDeleted}, {1, kDeleted}}), ev);
+	EXPECT_TRUE(h.Reclaim(std::chrono::milliseconds(100)));
+
+	ev.clear();
+	h.Clear();
+	EXPECT_EQ(Events(), ev);
+	EXPECT_FALSE(h.CanUndo());
+
+	h.ReclaimAll();
+	EXPECT_EQ(Events({{3, kDeleted}}), ev);
+}
+
+TEST(HistoryTest, Savepoints) {
+	Events ev;
+	History h;
+
+	h.Stage(MakeUnique<Tick>(1, ev));
+	auto outer = h.Mark();
+	h.Stage(MakeUnique<Tick>(2, ev));
+	auto inner = h.Mark();
+	h.Stage(MakeUnique<Tick>(3, ev));
+	ev.clear();
+
+	h.RollbackTo(inner);
+	EXPECT_EQ(Events({{3, kRevert}, {3, kDeleted}}), ev);
+
+	// The savepoint is kept after a rollback
+	ev.clear();
+	h.Stage(MakeUnique<Tick>(4, ev));
+	h.RollbackTo(inner);
+	EXPECT_EQ(Events({{4, kChange}, {4, kRevert}, {4, kDeleted}}), ev);
+
+	ev.clear();
+	h.Stage(MakeUnique<Tick>(5, ev));
+	h.RollbackTo(outer);
+	EXPECT_EQ(Events({{5, kChange}, {5, kRevert}, {5, kDeleted},
+		{2, kRevert}, {2, kDeleted}}), ev);
+
+	ev.clear();
+	h.Stage(MakeUnique<Tick>(6, ev));
+	h.Release(outer);
+	h.Commit();
+	EXPECT_EQ(Events({{6, kChange}}), ev);
+
+	ev.clear();
+	h.Undo();
+	EXPECT_EQ(Events({{6, kRevert}, {1, kRevert}}), ev);
+}
+
+TEST(HistoryTest, Squash) {
+	Events ev;
+	History h;
+
+	for (int i = 1; i <= 4; ++i) {
+		h.Stage(MakeUnique<Tick>(i, ev));
+		h.Commit();
+	}
+	EXPECT_EQ(4, h.Revision());
+
+	h.Squash(1, 3);
+	EXPECT_EQ(3, h.Revision());
+	ev.clear();
+
+	h.Undo();
+	h.Undo();
+	EXPECT_EQ(Events({{4, kRevert}, {3, kRevert}, {2, kRevert}}), ev);
+
+	ev.clear();
+	h.Redo();
+	EXPECT_EQ(Events({{2, kChange}, {3, kChange}}), ev);
+
+	h.Squash(0, 2);
+	EXPECT_EQ(1, h.Revision());
+	EXPECT_TRUE(h.CanRedo());
+	ev.clear();
+	h.Undo();
+	EXPECT_EQ(Events({{3, kRevert}, {2, kRevert}, {1, kRevert}}), ev);
+}
@@ -0,0 +1,115 @@
+#include "TestUtils.h"
+#include "undoable/Object.h"
+#include "undoable/Factory.h"
+#include "undoable/MapProperty.h"
+#include <map>
+#include <string>
+
+using namespace undoable;
+
+namespace {
+
+class Attributes
+	: public Object
+{
+public:
+	virtual void OnPropertyChange(Property* property) override {
+		++handler_count;
+	}
+
+	MapProperty<std::string, int> values{this};
+	MapProperty<int, int> numbers{this};
+	int handler_count = 0;
+};
+
+std::map<int, int> ToMap(const MapProperty<int, int>& prop) {
+	return std::map<int, int>(prop.begin(), prop.end());
+}
+
+} // namespace
+
+TEST(MapPropertyTest, Changes) {
+	Factory f;
+	auto& a = f.Create<Attributes>();
+
+	EXPECT_TRUE(a.values.IsEmpty());
+	EXPECT_TRUE(a.values.Insert("x", 1));
+	EXPECT_FALSE(a.values.Insert("x", 2));
+	EXPECT_EQ(1, a.values.At("x"));
+	EXPECT_EQ(1, a.handler_count);
+
+	a.values.Assign("x", 3);
+	a.values.Assign("y", 4);
+	a.values.Assign("y", 4);
+	EXPECT_EQ(3, a.values.At("x"));
+	EXPECT_EQ(4, a.values.At("y"));
+	EXPECT_EQ(2, a.values.Size());
+	EXPECT_EQ(3, a.handler_count);
+
+	EXPECT_TRUE(a.values.Erase("x"));
+	EXPECT_FALSE(a.values.Erase("x"));
+	EXPECT_FALSE(a.values.Contains("x"));
+	EXPECT_EQ((const int*)nullptr, a.values.Find("x"));
+	EXPECT_EQ(4, a.handler_count);
+}
+
+TEST(MapPropertyTest, UndoRedo) {
+	Factory f;
+	auto& h = f.GetHistory();
+	auto& a = f.Create<Attributes>();
+
+	a.values.Insert("x", 1);
+	a.values.Insert("y", 2);
+	h.Commit();
+
+	a.values.Assign("x", 5);
+	a.values.Erase("y");
+	a.values.Insert("z", 3);
+	h.Commit();
+
+	h.Undo();
+	EXPECT_EQ(2, a.values.Size());
+	EXPECT_EQ(1, a.values.At("x"));
+	EXPECT_EQ(2, a.values.At("y"));
+	EXPECT_FALSE(a.values.Contains("z"));
+
+	h.Redo();
+	EXPECT_EQ(2, a.values.Size());
+	EXPECT_EQ(5, a.values.At("x"));
+	EXPECT_EQ(3, a.values.At("z"));
+	EXPECT_FALSE(a.values.Contains("y"));
+
+	a.values.Clear();
+	EXPECT_TRUE(a.values.IsEmpty());
+	h.Unstage();
+	EXPECT_EQ(2, a.values.Size());
+	EXPECT_EQ(5, a.values.At("x"));
+}
+
+TEST(MapPropertyTest, ManyKeys) {
+	Factory f;
+	auto& h = f.GetHistory();
+	auto& a = f.Create<Attributes>();
+	std::map<int, int> expected;
+
+	for (int i = 0; i < 1000; ++i) {
+		a.numbers.Insert(i * 7, i);
+		expected[i * 7] = i;
+	}
+	h.Commit();
+	auto inserted = expected;
+
+	for (int i = 0; i < 1000; i += 3) {
+		a.numbers.Erase(i * 7);
+		expected.erase(i * 7);
+	}
+	h.Commit();
+	EXPECT_EQ(expected.size(), a.numbers.Size());
+	EXPECT_TRUE((expected == ToMap(a.numbers)));
+
+	h.Undo();
+	EXPECT_TRUE((inserted == ToMap(a.numbers)));
+
+	h.Redo();
+	EXPECT_TRUE((expected == ToMap(a.numbers)));
+}
@@ -377,3 +377,8 @@ TEST(ObjectTest, DestructInaccessible) {
 		MakeDestructEvent(&e3),
 	}), evs);
 }
+
+TEST(ObjectTest, HeaderSize) {
+	// Ring, property list, node list, reference ring and history/status
+	EXPECT_TRUE(sizeof(Object) <= 9 * sizeof(void*));
+}
@@ -0,0 +1,144 @@
+#include <atomic>
+#include <string>
+#include <vector>
+#include "TestUtils.h"
+#include "undoable/Object.h"
+#include "undoable/Factory.h"
+#include "undoable/ThreadPool.h"
+#include "undoable/ValueProperty.h"
+#include "undoable/VectorProperty.h"
+
+using namespace undoable;
+
+namespace {
+
+std::vector<Property*>& Notifications() {
+	static std::vector<Property*> notifications;
+	return notifications;
+}
+
+class Element
+	: public Object
+{
+public:
+	ValueProperty<std::string> name{this};
+	ValueProperty<float> weight{this};
+	VectorProperty<int> items{this};
+
+	virtual void OnPropertyChange(Property* property) override {
+		Notifications().push_back(property);
+	}
+};
+
+} // namespace
+
+TEST(ParallelTest, ThreadPool) {
+	ThreadPool pool(4);
+	EXPECT_EQ(4, pool.Size());
+
+	for (int round = 0; round < 100; ++round) {
+		std::vector<std::atomic<int>> calls(round);
+		pool.Run(calls.size(), [&](std::size_t i) {
+			++calls[i];
+		});
+		for (auto& count : calls) {
+			EXPECT_EQ(1, count.load());
+		}
+	}
+}
+
+TEST(ParallelTest, UndoRedo) {
+	Factory f;
+	auto& h = f.GetHistory();
+	std::vector<Element*> elements;
+	for (int i = 0; i < 1000; ++i) {
+		elements.push_back(&f.Create<Element>());
+	}
+	h.Commit();
+
+	for (int i = 0; i < 1000; ++i) {
+		auto& e = *elements[i];
+		e.name.Set("a" + std::to_string(i));
+		e.items.PushBack(i);
+		e.name.Set("b" + std::to_string(i));
+		if (i == 500) {
+			// Barrier between two runs of partitioned commands
+			f.Create<Element>();
+		}
+	}
+	h.Commit();
+
+	// Sequential order of notifications
+	Notifications().clear();
+	h.Undo();
+	auto undo_order = Notifications();
+	Notifications().clear();
+	h.Redo();
+	auto redo_order = Notifications();
+
+	ThreadPool pool(4);
+	h.SetThreadPool(&pool);
+
+	Notifications().clear();
+	h.Undo();
+	EXPECT_TRUE((undo_order == Notifications()));
+	for (auto* e : elements) {
+		EXPECT_EQ("", e->name.Get());
+		EXPECT_EQ(0, e->items.Size());
+	}
+
+	Notifications().clear();
+	h.Redo();
+	EXPECT_TRUE((redo_order == Notifications()));
+	for (int i = 0; i < 1000; ++i) {
+		EXPECT_EQ("b" + std::to_string(i), elements[i]->name.Get());
+		EXPECT_EQ(1, elements[i]->items.Size());
+	}
+
+	h.SetThreadPool(nullptr);
+	h.Undo();
+	EXPECT_EQ("", elements[0]->name.Get());
+}
+
+TEST(ParallelTest, Batch) {
+	Factory f;
+	auto& h = f.GetHistory();
+	std::vector<Element*> elements;
+	for (int i = 0; i < 1000; ++i) {
+		elements.push_back(&f.Create<Element>());
+	}
+	h.Commit();
+
+	// Merged into a single batch spanning all elements
+	for (int round = 1; round <= 2; ++round) {
+		for (int i = 0; i < 1000; ++i) {
+			elements[i]->weight.Set(float(round * 1000 + i));
+		}
+	}
+	h.Commit();
+
+	Notifications().clear();
+	h.Undo();
+	auto undo_order = Notifications();
+	Notifications().clear();
+	h.Redo();
+	auto redo_order = Notifications();
+	EXPECT_EQ(2000, redo_order.size());
+
+	ThreadPool pool(4);
+	h.SetThreadPool(&pool);
+
+	Notifications().clear();
+	h.Undo();
+	EXPECT_TRUE((undo_order == Notifications()));
+	for (auto* e : elements) {
+		EXPECT_EQ(0.0f, e->weight.Get());
+	}
+
+	Notifications().clear();
+	h.Redo();
+	EXPECT_TRUE((redo_order == Notifications()));
+	for (int i = 0; i < 1000; ++i) {
+		EXPECT_EQ(float(2000 + i), elements[i]->weight.Get());
+	}
+}
@@ -0,0 +1,64 @@
+#include "TestUtils.h"
+#include "undoable/Object.h"
+#include "undoable/Factory.h"
+#include "undoable/SharedValue.h"
+#include <string>
+
+using namespace undoable;
+
+namespace {
+
+class Document
+	: public Object
+{
+public:
+	Document() = default;
+	Document(const Document& other)
+		: text(this, other.text.Get())
+	{}
+
+	SharedValueProperty<std::string> text{this};
+};
+
+} // namespace
+
+TEST(SharedValueTest, Equality) {
+	SharedValue<std::string> a;
+	SharedValue<std::string> b;
+	SharedValue<std::string> c("text");
+	SharedValue<std::string> d("text");
+
+	EXPECT_TRUE(a.IsSame(b));
+	EXPECT_EQ("", a.Get());
+	EXPECT_FALSE(c.IsSame(d));
+	EXPECT_TRUE((c == d));
+	EXPECT_TRUE((a != c));
+
+	auto e = c;
+	EXPECT_TRUE(e.IsSame(c));
+	EXPECT_EQ(4, e->size());
+}
+
+TEST(SharedValueTest, UndoRedo) {
+	Factory f;
+	auto& h = f.GetHistory();
+	auto& d1 = f.Create<Document>();
+
+	d1.text.Set(std::string("first"));
+	h.Commit();
+	auto first = d1.text.Get();
+
+	d1.text.Set(std::string("second"));
+	h.Commit();
+	EXPECT_EQ("second", *d1.text.Get());
+
+	h.Undo();
+	EXPECT_EQ("first", *d1.text.Get());
+	EXPECT_TRUE(first.IsSame(d1.text.Get()));
+
+	h.Redo();
+	EXPECT_EQ("second", *d1.text.Get());
+
+	auto& d2 = f.Create<Document>(d1);
+	EXPECT_TRUE(d2.text.Get().IsSame(d1.text.Get()));
+}
@@ -0,0 +1,138 @@
+#include "TestUtils.h"
+#include "undoable/Object.h"
+#include "undoable/Factory.h"
+#include "undoable/Fragment.h"
+#include "undoable/Snapshot.h"
+#include <atomic>
+#include <string>
+#include <thread>
+
+using namespace undoable;
+
+namespace {
+
+class Position
+	: public Fragment
+{
+public:
+	using Fragment::Fragment;
+	ValueProperty<int> x{this};
+};
+
+class Element
+	: public Object
+	, public ListNode<Element, struct tag_children>
+{
+public:
+	ValueProperty<std::string> name{this};
+	Position position{this};
+	RefProperty<Element> target{this};
+	ListProperty<Element, struct tag_children> children{this};
+};
+
+} // namespace
+
+TEST(SnapshotTest, Revisions) {
+	Factory f;
+	auto& h = f.GetHistory();
+	auto& e1 = f.Create<Element>();
+	h.Commit();
+
+	SnapshotManager manager(f);
+	auto s1 = manager.Pin();
+	EXPECT_EQ(s1, manager.Pin());
+
+	auto& e2 = f.Create<Element>();
+	e1.name.Set("e1");
+	e1.position.x.Set(3);
+	e1.target.Set(&e2);
+	e1.children.LinkBack(e2);
+
+	EXPECT_EQ(s1, manager.Pin());
+	h.Commit();
+	auto s2 = manager.Pin();
+
+	EXPECT_EQ(1, s1->Size());
+	EXPECT_EQ("", *s1->Get(e1, e1.name));
+	EXPECT_EQ(0, *s1->Get(e1, e1.position.x));
+	EXPECT_EQ((const Element*)nullptr, s1->Get(e1, e1.target));
+	EXPECT_TRUE(s1->Get(e1, e1.children)->empty());
+	EXPECT_FALSE(s1->Contains(e2));
+
+	EXPECT_EQ(2, s2->Size());
+	EXPECT_EQ("e1", *s2->Get(e1, e1.name));
+	EXPECT_EQ(3, *s2->Get(e1, e1.position.x));
+	EXPECT_EQ(&e2, s2->Get(e1, e1.target));
+	EXPECT_EQ(std::vector<const Element*>{&e2}, *s2->Get(e1, e1.children));
+
+	h.Undo();
+	auto s3 = manager.Pin();
+	EXPECT_EQ(1, s3->Size());
+	EXPECT_EQ("", *s3->Get(e1, e1.name));
+	EXPECT_EQ("e1", *s2->Get(e1, e1.name));
+}
+
+TEST(SnapshotTest, SharedBuckets) {
+	Factory f;
+	auto& h = f.GetHistory();
+	SnapshotManager manager(f);
+	auto empty = manager.Pin();
+
+	std::vector<Element*> elements;
+	for (int i = 0; i < 3000; ++i) {
+		elements.push_back(&f.Create<Element>());
+	}
+	h.Commit();
+	auto s1 = manager.Pin();
+
+	elements[0]->name.Set("first");
+	elements[2999]->Destroy();
+	h.Commit();
+	auto s2 = manager.Pin();
+
+	EXPECT_EQ(0, empty->Size());
+	EXPECT_FALSE(empty->Contains(*elements[0]));
+
+	EXPECT_EQ(3000, s1->Size());
+	EXPECT_EQ("", *s1->Get(*elements[0], elements[0]->name));
+	EXPECT_TRUE(s1->Contains(*elements[2999]));
+
+	EXPECT_EQ(2999, s2->Size());
+	EXPECT_EQ("first", *s2->Get(*elements[0], elements[0]->name));
+	EXPECT_FALSE(s2->Contains(*elements[2999]));
+	for (int i = 1; i < 2999; ++i) {
+		EXPECT_TRUE(s2->Contains(*elements[i]));
+	}
+}
+
+TEST(SnapshotTest, Threads) {
+	Factory f;
+	auto& h = f.GetHistory();
+	auto& e1 = f.Create<Element>();
+	h.Commit();
+
+	SnapshotManager manager(f);
+	std::atomic<int> errors{0};
+	std::vector<std::thread> readers;
+
+	for (int i = 0; i < 100; ++i) {
+		e1.position.x.Set(i);
+		e1.name.Set(std::to_string(i));
+		h.Commit();
+
+		auto snapshot = manager.Pin();
+		readers.emplace_back([snapshot, &e1, &errors]() {
+			for (int k = 0; k < 100; ++k) {
+				auto x = *snapshot->Get(e1, e1.position.x);
+				if (*snapshot->Get(e1, e1.name) != std::to_string(x)) {
+					++errors;
+				}
+			}
+		});
+	}
+
+	for (auto& reader : readers) {
+		reader.join();
+	}
+	EXPECT_EQ(0, errors.load());
+}
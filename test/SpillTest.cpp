@@ -0,0 +1,275 @@
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "TestUtils.h"
+#include "undoable/Object.h"
+#include "undoable/Factory.h"
+#include "undoable/SpillFile.h"
+#include "undoable/BufferProperty.h"
+#include "undoable/ValueProperty.h"
+#include "undoable/RefProperty.h"
+#include "undoable/VectorProperty.h"
+
+using namespace undoable;
+
+namespace {
+
+class Document
+	: public Object
+{
+public:
+	TextProperty text{this};
+	VectorProperty<int> values{this};
+	VectorProperty<std::string> names{this};
+	VectorProperty<bool> flags{this};
+	ValueProperty<int> count{this};
+	ValueProperty<std::string> title{this};
+	RefProperty<Document> link{this};
+};
+
+std::string Text(int i) {
+	return std::string(1000, static_cast<char>('a' + i));
+}
+
+class FailingStore
+	: public SpillStore
+{
+public:
+	virtual std::uint64_t Put(const std::vector<char>& bytes) override {
+		if (full) {
+			return kNotStored;
+		}
+		stored.push_back(bytes);
+		return stored.size() - 1;
+	}
+
+	virtual std::vector<char> Take(std::uint64_t id) override {
+		if (unreadable) {
+			throw std::runtime_error("unreadable");
+		}
+		return stored[id];
+	}
+
+	virtual void Drop(std::uint64_t id) override {}
+
+	std::vector<std::vector<char>> stored;
+	bool full = true;
+	bool unreadable = false;
+};
+
+} // namespace
+
+TEST(SpillTest, UndoRedo) {
+	SpillFile file;
+	EXPECT_TRUE(file.IsOpen());
+
+	Factory f;
+	auto& h = f.GetHistory();
+	auto& doc = f.Create<Document>();
+	h.Commit();
+	h.SetSpillStore(&file, 2);
+
+	for (int i = 0; i < 10; ++i) {
+		doc.text.Set(Text(i));
+		doc.values.Clear();
+		std::vector<int> values(100, i);
+		doc.values.Insert(0, values.begin(), values.end());
+		doc.names.PushBack(std::to_string(i));
+		doc.flags.PushBack(i % 2 == 0);
+		h.Commit();
+	}
+	EXPECT_TRUE((file.Size() > 8000));
+
+	for (int i = 9; i >= 0; --i) {
+		EXPECT_EQ(Text(i), doc.text.Get());
+		EXPECT_EQ(100, doc.values.Size());
+		EXPECT_EQ(i, doc.values[0]);
+		EXPECT_EQ(std::to_string(i), doc.names[i]);
+		h.Undo();
+	}
+	EXPECT_EQ("", doc.text.Get());
+	EXPECT_EQ(0, doc.names.Size());
+	EXPECT_EQ(0, file.Size());
+
+	while (h.CanRedo()) {
+		h.Redo();
+	}
+	EXPECT_EQ(Text(9), doc.text.Get());
+	EXPECT_EQ(10, doc.flags.Size());
+
+	h.Undo();
+	h.Undo();
+	h.Undo();
+	EXPECT_EQ(Text(6), doc.text.Get());
+
+	// Spilled transactions are dropped with the history
+	h.Clear();
+	EXPECT_EQ(0, file.Size());
+	h.SetSpillStore(nullptr, 0);
+}
+
+TEST(SpillTest, FileReuse) {
+	SpillFile file;
+	auto a = file.Put(std::vector<char>(100, 'a'));
+	auto b = file.Put(std::vector<char>(100, 'b'));
+	auto c = file.Put(std::vector<char>(100, 'c'));
+	EXPECT_EQ(300, file.Extent());
+
+	file.Drop(b);
+	auto d = file.Put(std::vector<char>(60, 'd'));
+	auto e = file.Put(std::vector<char>(40, 'e'));
+	EXPECT_EQ(300, file.Extent());
+	EXPECT_EQ(300, file.Size());
+	EXPECT_TRUE((file.Take(d) == std::vector<char>(60, 'd')));
+	EXPECT_TRUE((file.Take(c) == std::vector<char>(100, 'c')));
+	EXPECT_EQ(200, file.Extent());
+
+	auto empty = file.Put({});
+	EXPECT_TRUE(file.Take(empty).empty());
+	EXPECT_TRUE((file.Take(e) == std::vector<char>(40, 'e')));
+	EXPECT_TRUE((file.Take(a) == std::vector<char>(100, 'a')));
+	EXPECT_EQ(0, file.Extent());
+	EXPECT_EQ(0, file.Size());
+}
+
+TEST(SpillTest, Values) {
+	SpillFile file;
+	Factory f;
+	auto& h = f.GetHistory();
+	std::vector<Document*> docs;
+	for (int i = 0; i < 100; ++i) {
+		docs.push_back(&f.Create<Document>());
+	}
+	h.Commit();
+	h.SetSpillStore(&file, 0);
+
+	// Batched values and before-images of ValueProperty changes
+	for (int round = 1; round <= 2; ++round) {
+		for (auto* doc : docs) {
+			doc->count.Set(round);
+		}
+		for (auto* doc : docs) {
+			doc->title.Set(Text(round));
+		}
+		h.Commit();
+	}
+	EXPECT_TRUE((file.Size() > 100 * 1000 + 99 * sizeof(int)));
+
+	h.Undo();
+	h.Undo();
+	EXPECT_EQ(0, file.Size());
+	for (auto* doc : docs) {
+		EXPECT_EQ(0, doc->count.Get());
+		EXPECT_EQ("", doc->title.Get());
+	}
+
+	h.Redo();
+	EXPECT_EQ(1, docs[99]->count.Get());
+	EXPECT_EQ(Text(1), docs[99]->title.Get());
+	h.SetSpillStore(nullptr, 0);
+}
+
+TEST(SpillTest, NoPayload) {
+	SpillFile file;
+	Factory f;
+	auto& h = f.GetHistory();
+	auto& doc = f.Create<Document>();
+	auto& other = f.Create<Document>();
+	h.Commit();
+	h.SetSpillStore(&file, 0);
+
+	// Reference changes have nothing to spill
+	for (int i = 1; i <= 5; ++i) {
+		doc.link.Set(i % 2 ? &other : nullptr);
+		h.Commit();
+	}
+	EXPECT_EQ(0, file.Extent());
+
+	for (int i = 5; i > 0; --i) {
+		EXPECT_EQ(i % 2 == 1, bool(doc.link));
+		h.Undo();
+	}
+	EXPECT_FALSE(doc.link);
+	h.Redo();
+	EXPECT_EQ(&other, &*doc.link);
+	h.SetSpillStore(nullptr, 0);
+}
+
+TEST(SpillTest, StoreFailure) {
+	FailingStore store;
+	Factory f;
+	auto& h = f.GetHistory();
+	auto& doc = f.Create<Document>();
+	h.Commit();
+	h.SetSpillStore(&store, 0);
+
+	// Payloads stay in memory if the store is full
+	doc.text.Set(Text(1));
+	h.Commit();
+	doc.text.Set(Text(2));
+	h.Commit();
+	EXPECT_TRUE(store.stored.empty());
+	h.Undo();
+	EXPECT_EQ(Text(1), doc.text.Get());
+
+	store.full = false;
+	doc.text.Set(Text(3));
+	h.Commit();
+	EXPECT_EQ(2, store.stored.size());
+
+	// A failed read leaves the history unchanged
+	store.unreadable = true;
+	bool thrown = false;
+	try {
+		h.Undo();
+	} catch (const std::runtime_error&) {
+		thrown = true;
+	}
+	EXPECT_TRUE(thrown);
+	EXPECT_EQ(Text(3), doc.text.Get());
+	EXPECT_TRUE(h.CanUndo());
+
+	store.unreadable = false;
+	h.Undo();
+	EXPECT_EQ(Text(1), doc.text.Get());
+	h.Undo();
+	EXPECT_EQ("", doc.text.Get());
+	h.SetSpillStore(nullptr, 0);
+}
+
+TEST(SpillTest, Tombstone) {
+	SpillFile file;
+	Factory f;
+	auto& h = f.GetHistory();
+	h.SetSpillStore(&file, 0);
+
+	auto& doc = f.Create<Document>();
+	doc.text.Set(Text(0));
+	auto docs = f.CreateMany<Document>(10, [](Document& d, std::size_t i) {
+		d.text.Set(Text(static_cast<int>(i)));
+	});
+	h.Commit();
+	auto base = file.Size();
+
+	doc.Destroy();
+	h.Commit();
+	EXPECT_TRUE((file.Size() >= base + 1000));
+	EXPECT_EQ(0, doc.text.Size());
+
+	f.DestroyMany(docs);
+	h.Commit();
+	EXPECT_TRUE((file.Size() >= base + 11000));
+	EXPECT_EQ(0, docs[5]->text.Size());
+
+	h.Undo();
+	EXPECT_TRUE(docs[5]->IsCreated());
+	EXPECT_EQ(Text(5), docs[5]->text.Get());
+
+	h.Undo();
+	EXPECT_TRUE(doc.IsCreated());
+	EXPECT_EQ(Text(0), doc.text.Get());
+
+	h.Redo();
+	EXPECT_TRUE(doc.IsDestroyed());
+	h.SetSpillStore(nullptr, 0);
+}
@@ -0,0 +1,104 @@
+#include "TestUtils.h"
+#include "undoable/Object.h"
+#include "undoable/Factory.h"
+#include "undoable/StructProperty.h"
+#include "undoable/ValueProperty.h"
+#include <string>
+
+using namespace undoable;
+
+namespace {
+
+struct ShapeData {
+	int x = 0;
+	int y = 0;
+	std::string name;
+};
+
+class Shape
+	: public Object
+{
+public:
+	virtual void OnPropertyChange(Property* property) override {
+		last_changed = property;
+	}
+
+	StructProperty<ShapeData> data{this};
+	Property* last_changed = nullptr;
+};
+
+} // namespace
+
+TEST(StructPropertyTest, Size) {
+	struct Point {
+		int x;
+		int y;
+	};
+
+	EXPECT_TRUE(
+		sizeof(StructProperty<Point>) < 2 * sizeof(ValueProperty<int>));
+}
+
+TEST(StructPropertyTest, UndoRedo) {
+	Factory f;
+	auto& h = f.GetHistory();
+	auto& s = f.Create<Shape>();
+
+	s.data.Set(&ShapeData::x, 3);
+	s.data.Set(&ShapeData::name, "box");
+	h.Commit();
+	EXPECT_EQ(3, s.data->x);
+	EXPECT_EQ("box", s.data.Get(&ShapeData::name));
+	EXPECT_EQ(&s.data, s.last_changed);
+
+	s.data.Set(&ShapeData::x, 5);
+	s.data.Set(&ShapeData::y, 7);
+	h.Commit();
+
+	s.data.Set(&ShapeData::y, 7);
+	EXPECT_FALSE(h.CanCommit());
+
+	h.Undo();
+	EXPECT_EQ(3, s.data->x);
+	EXPECT_EQ(0, s.data->y);
+
+	h.Undo();
+	EXPECT_EQ(0, s.data->x);
+	EXPECT_EQ("", s.data->name);
+
+	h.Redo();
+	h.Redo();
+	EXPECT_EQ(5, s.data->x);
+	EXPECT_EQ(7, s.data->y);
+	EXPECT_EQ("box", s.data->name);
+}
+
+TEST(StructPropertyTest, Reset) {
+	Factory f;
+	auto& h = f.GetHistory();
+	auto& s = f.Create<Shape>();
+
+	ShapeData data;
+	data.x = 1;
+	data.y = 2;
+	data.name = "circle";
+	s.data.Assign(data);
+	h.Commit();
+
+	s.data.Reset(&ShapeData::x);
+	EXPECT_EQ(0, s.data->x);
+	EXPECT_EQ(2, s.data->y);
+	h.Commit();
+
+	s.data.Reset();
+	EXPECT_EQ(0, s.data->y);
+	EXPECT_EQ("", s.data->name);
+	h.Commit();
+
+	h.Undo();
+	EXPECT_EQ("circle", s.data->name);
+	h.Undo();
+	EXPECT_EQ(1, s.data->x);
+	h.Undo();
+	EXPECT_EQ(0, s.data->y);
+}
@@ -1,5 +1,7 @@
 #include "TestUtils.h"
 #include "undoable/ValueProperty.h"
+#include "undoable/Object.h"
+#include "undoable/Factory.h"
 
 using namespace undoable;
 
@@ -41,6 +43,36 @@ public:
 	ValueProperty<std::vector<int>> prop_vec;
 };
 
+class Point
+	: public Object
+{
+public:
+	virtual void OnPropertyChange(Property* property) override {
+		++handler_count;
+	}
+
+	ValueProperty<float> x{this};
+	ValueProperty<float> y{this};
+	ValueProperty<std::string> name{this};
+	ValueProperty<bool> visible{this};
+	int handler_count = 0;
+};
+
+class Tracker
+	: public Object
+{
+public:
+	virtual void OnPropertyChange(Property* property) override {
+		seen.emplace_back(x.Get(), y.Get());
+		order.push_back(property);
+	}
+
+	ValueProperty<int> x{this};
+	ValueProperty<int> y{this};
+	std::vector<std::pair<int, int>> seen;
+	std::vector<Property*> order;
+};
+
 } // namespace
 
 TEST(ValuePropertyTest, Init) {
@@ -91,3 +123,159 @@ TEST(ValuePropertyTest, Equality) {
 	s.prop_int1.Set(12);
 	EXPECT_EQ(1, s.apply_count);
 }
+
+TEST(ValuePropertyTest, Batch) {
+	Factory f;
+	auto& h = f.GetHistory();
+	auto& p1 = f.Create<Point>();
+	auto& p2 = f.Create<Point>();
+	h.Commit();
+
+	p1.x.Set(1);
+	p2.x.Set(2);
+	p1.x.Set(3);
+	p1.y.Set(4);
+	h.Commit();
+	EXPECT_EQ(3, p1.handler_count);
+	EXPECT_EQ(1, p2.handler_count);
+
+	h.Undo();
+	EXPECT_EQ(0, p1.x.Get());
+	EXPECT_EQ(0, p1.y.Get());
+	EXPECT_EQ(0, p2.x.Get());
+	EXPECT_EQ(6, p1.handler_count);
+	EXPECT_EQ(2, p2.handler_count);
+
+	h.Redo();
+	EXPECT_EQ(3, p1.x.Get());
+	EXPECT_EQ(4, p1.y.Get());
+	EXPECT_EQ(2, p2.x.Get());
+
+	p2.y.Set(5);
+	p2.y.Set(6);
+	h.Unstage();
+	EXPECT_EQ(0, p2.y.Get());
+}
+
+TEST(ValuePropertyTest, BatchSavepoint) {
+	Factory f;
+	auto& h = f.GetHistory();
+	auto& p = f.Create<Point>();
+	h.Commit();
+
+	p.x.Set(1);
+	auto savepoint = h.Mark();
+	p.x.Set(2);
+	p.y.Set(3);
+	h.RollbackTo(savepoint);
+	EXPECT_EQ(1, p.x.Get());
+	EXPECT_EQ(0, p.y.Get());
+
+	h.Commit();
+	h.Undo();
+	EXPECT_EQ(0, p.x.Get());
+}
+
+TEST(ValuePropertyTest, Squash) {
+	Factory f;
+	auto& h = f.GetHistory();
+	auto& p = f.Create<Point>();
+	h.Commit();
+
+	for (int i = 1; i <= 5; ++i) {
+		p.name.Set(std::to_string(i));
+		h.Commit();
+	}
+	h.Squash(1, 6);
+	EXPECT_EQ(2, h.Revision());
+	EXPECT_EQ("5", p.name.Get());
+
+	// The changes of the name are merged into one
+	p.handler_count = 0;
+	h.Undo();
+	EXPECT_EQ("", p.name.Get());
+	EXPECT_EQ(1, p.handler_count);
+	h.Redo();
+	EXPECT_EQ("5", p.name.Get());
+}
+
+TEST(ValuePropertyTest, SquashBatch) {
+	Factory f;
+	auto& h = f.GetHistory();
+	auto& p1 = f.Create<Point>();
+	auto& p2 = f.Create<Point>();
+	h.Commit();
+
+	for (int i = 1; i <= 5; ++i) {
+		p1.x.Set(float(i));
+		p2.x.Set(float(i * 10));
+		p1.y.Set(float(i % 2));
+		h.Commit();
+	}
+	h.Squash(1, 6);
+	EXPECT_EQ(2, h.Revision());
+
+	// One entry is kept per property
+	p1.handler_count = 0;
+	p2.handler_count = 0;
+	h.Undo();
+	EXPECT_EQ(0.0f, p1.x.Get());
+	EXPECT_EQ(0.0f, p2.x.Get());
+	EXPECT_EQ(0.0f, p1.y.Get());
+	EXPECT_EQ(2, p1.handler_count);
+	EXPECT_EQ(1, p2.handler_count);
+
+	h.Redo();
+	EXPECT_EQ(5.0f, p1.x.Get());
+	EXPECT_EQ(50.0f, p2.x.Get());
+	EXPECT_EQ(1.0f, p1.y.Get());
+	EXPECT_EQ(4, p1.handler_count);
+}
+
+TEST(ValuePropertyTest, BatchNotifyOrder) {
+	Factory f;
+	auto& h = f.GetHistory();
+	auto& t = f.Create<Tracker>();
+	h.Commit();
+
+	t.x.Set(1);
+	t.y.Set(2);
+	h.Commit();
+
+	// Owners are notified in the order of the restore,
+	// after all values of the batch are restored
+	t.seen.clear();
+	t.order.clear();
+	h.Undo();
+	EXPECT_TRUE((t.seen == std::vector<std::pair<int, int>>{{0, 0}, {0, 0}}));
+	EXPECT_TRUE((t.order == std::vector<Property*>{&t.y, &t.x}));
+
+	t.seen.clear();
+	t.order.clear();
+	h.Redo();
+	EXPECT_TRUE((t.seen == std::vector<std::pair<int, int>>{{1, 2}, {1, 2}}));
+	EXPECT_TRUE((t.order == std::vector<Property*>{&t.x, &t.y}));
+}
+
+TEST(ValuePropertyTest, Bool) {
+	Factory f;
+	auto& h = f.GetHistory();
+	auto& p1 = f.Create<Point>();
+	auto& p2 = f.Create<Point>();
+	h.Commit();
+
+	p1.visible.Set(true);
+	p2.visible.Set(true);
+	p1.visible.Set(false);
+	h.Commit();
+	EXPECT_FALSE(p1.visible.Get());
+	EXPECT_TRUE(p2.visible.Get());
+
+	h.Undo();
+	EXPECT_FALSE(p1.visible.Get());
+	EXPECT_FALSE(p2.visible.Get());
+
+	h.Redo();
+	EXPECT_FALSE(p1.visible.Get());
+	EXPECT_TRUE(p2.visible.Get());
+}
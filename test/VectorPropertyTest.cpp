@@ -0,0 +1,110 @@
+#include "TestUtils.h"
+#include "undoable/Object.h"
+#include "undoable/Factory.h"
+#include "undoable/VectorProperty.h"
+
+using namespace undoable;
+
+namespace {
+
+class Store
+	: public PropertyOwner
+{
+public:
+	Store()
+		: prop_vec(this, {5, 7})
+	{}
+
+	virtual void ApplyPropertyChange(UniquePtr<Command> cmd) override {
+		++apply_count;
+		cmd->Apply(false);
+	}
+
+	virtual void OnPropertyChange(Property* property) override {
+		++handler_count;
+	}
+
+	int apply_count = 0;
+	int handler_count = 0;
+
+	VectorProperty<int> prop_vec;
+};
+
+class Polyline
+	: public Object
+{
+public:
+	VectorProperty<int> points{this};
+};
+
+using Vec = std::vector<int>;
+
+} // namespace
+
+TEST(VectorPropertyTest, Changes) {
+	Store s;
+
+	EXPECT_EQ(Vec({5, 7}), s.prop_vec.Get());
+	EXPECT_EQ(2, s.prop_vec.Size());
+
+	s.prop_vec.PushBack(9);
+	s.prop_vec.Insert(0, 3);
+	EXPECT_EQ(Vec({3, 5, 7, 9}), s.prop_vec.Get());
+
+	s.prop_vec.SetAt(1, 6);
+	s.prop_vec.Erase(2);
+	EXPECT_EQ(Vec({3, 6, 9}), s.prop_vec.Get());
+	EXPECT_EQ(4, s.apply_count);
+	EXPECT_EQ(4, s.handler_count);
+
+	s.prop_vec.SetAt(1, 6);
+	EXPECT_EQ(4, s.apply_count);
+
+	Vec more = {1, 2};
+	s.prop_vec.Insert(1, more.begin(), more.end());
+	EXPECT_EQ(Vec({3, 1, 2, 6, 9}), s.prop_vec.Get());
+
+	s.prop_vec.Replace(3, more.begin(), more.end());
+	EXPECT_EQ(Vec({3, 1, 2, 1, 2}), s.prop_vec.Get());
+
+	s.prop_vec.Erase(0, 2);
+	s.prop_vec.PopBack();
+	EXPECT_EQ(Vec({2, 1}), s.prop_vec.Get());
+
+	s.prop_vec.Clear();
+	EXPECT_TRUE(s.prop_vec.IsEmpty());
+	EXPECT_EQ(9, s.apply_count);
+}
+
+TEST(VectorPropertyTest, UndoRedo) {
+	Factory f;
+	auto& h = f.GetHistory();
+	auto& p = f.Create<Polyline>();
+
+	Vec init = {1, 2, 3, 4};
+	p.points.Insert(0, init.begin(), init.end());
+	h.Commit();
+
+	p.points.SetAt(2, 30);
+	p.points.PushBack(5);
+	h.Commit();
+
+	p.points.Erase(0, 2);
+	p.points.Insert(1, 7);
+	h.Commit();
+	EXPECT_EQ(Vec({30, 7, 4, 5}), p.points.Get());
+
+	h.Undo();
+	EXPECT_EQ(Vec({1, 2, 30, 4, 5}), p.points.Get());
+
+	h.Undo();
+	EXPECT_EQ(Vec({1, 2, 3, 4}), p.points.Get());
+
+	h.Redo();
+	h.Redo();
+	EXPECT_EQ(Vec({30, 7, 4, 5}), p.points.Get());
+
+	p.points.Clear();
+	h.Unstage();
+	EXPECT_EQ(Vec({30, 7, 4, 5}), p.points.Get());
+}
@@ -0,0 +1,67 @@
+#include "TestUtils.h"
+#include "undoable/Object.h"
+#include "undoable/Factory.h"
+#include "undoable/Fragment.h"
+#include "undoable/ValueProperty.h"
+#include "undoable/ListProperty.h"
+
+using namespace undoable;
+
+namespace {
+
+class Position
+	: public Fragment
+{
+public:
+	using Fragment::Fragment;
+	ValueProperty<int> x{this};
+	ValueProperty<int> y{this};
+};
+
+class Element
+	: public Object
+	, public ListNode<Element, struct tag_children>
+{
+public:
+	ValueProperty<int> value{this};
+	Position position{this};
+	ListProperty<Element, struct tag_children> children{this};
+};
+
+} // namespace
+
+TEST(VersionTest, Increment) {
+	Factory f;
+	auto& h = f.GetHistory();
+	auto& e1 = f.Create<Element>();
+	auto& e2 = f.Create<Element>();
+	h.Commit();
+
+	EXPECT_EQ(0, e1.Version());
+	EXPECT_EQ(0, e1.value.Version());
+
+	e1.value.Set(1);
+	e1.value.Set(2);
+	EXPECT_EQ(2, e1.value.Version());
+	EXPECT_EQ(2, e1.Version());
+
+	e1.position.x.Set(3);
+	EXPECT_EQ(1, e1.position.x.Version());
+	EXPECT_EQ(0, e1.position.y.Version());
+	EXPECT_EQ(1, e1.position.Version());
+	EXPECT_EQ(3, e1.Version());
+
+	e1.children.LinkBack(e2);
+	EXPECT_EQ(1, e1.children.Version());
+	EXPECT_EQ(4, e1.Version());
+	EXPECT_EQ(0, e2.Version());
+	h.Commit();
+
+	h.Undo();
+	EXPECT_EQ(4, e1.value.Version());
+	EXPECT_EQ(2, e1.position.Version());
+	EXPECT_EQ(8, e1.Version());
+
+	h.Redo();
+	EXPECT_EQ(12, e1.Version());
+}